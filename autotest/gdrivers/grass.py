@@ -12,10 +12,44 @@
 #
 ###############################################################################
 
+import os
+import shutil
+import struct
+import sys
+
+import pytest
 from osgeo import gdal
 import gdaltest
 
 
+###############################################################################
+# Writable copy of the test location
+
+
+@pytest.fixture()
+def grass_location(tmp_path):
+    location = tmp_path / "small_grass_dataset"
+    shutil.copytree("./data/small_grass_dataset", str(location))
+    return location
+
+
+def make_group(mapset, name, maps):
+    group = mapset / "group" / name
+    group.mkdir(parents=True)
+    with open(str(group / "REF"), "w") as f:
+        for map_name in maps:
+            f.write("%s %s\n" % (map_name, mapset.name))
+    return group
+
+
+def copy_map(mapset, name, new_name):
+    for element in ("cellhd", "cell"):
+        shutil.copy(str(mapset / element / name), str(mapset / element / new_name))
+    shutil.copytree(
+        str(mapset / "cell_misc" / name), str(mapset / "cell_misc" / new_name)
+    )
+
+
 ###############################################################################
 # Test if GRASS driver is present
 
@@ -67,3 +101,895 @@ def test_grass_3():
     assert band.GetMaximum() == 27.0
     assert band.GetMetadataItem("COLOR_TABLE_RULES_COUNT") == "0"
     assert band.GetColorInterpretation() == 1  # GCI_GrayIndex
+
+
+###############################################################################
+# Read with multi-row blocks
+
+
+def test_grass_block_ysize():
+    ds = gdal.OpenEx(
+        "./data/small_grass_dataset/demomapset/cellhd/elevation",
+        open_options=["BLOCK_YSIZE=16"],
+    )
+    band = ds.GetRasterBand(1)
+    assert band.GetBlockSize() == [245, 16]
+    assert band.Checksum() == 41487
+
+    ds = gdal.OpenEx(
+        "./data/small_grass_dataset/demomapset/cellhd/elevation",
+        open_options=["BLOCK_YSIZE=AUTO"],
+    )
+    band = ds.GetRasterBand(1)
+    assert band.GetBlockSize()[1] > 1
+    assert band.Checksum() == 41487
+
+
+def test_grass_native_decoder():
+    ds = gdal.OpenEx(
+        "./data/small_grass_dataset/demomapset/cellhd/elevation",
+        open_options=["NATIVE_DECODER=YES"],
+    )
+    band = ds.GetRasterBand(1)
+    assert band.Checksum() == 41487
+    data = band.ReadRaster(10, 20, 50, 40, 25, 20)
+    ref = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    assert data == ref.GetRasterBand(1).ReadRaster(10, 20, 50, 40, 25, 20)
+
+
+###############################################################################
+# Uncompressed maps without null file, read from a memory mapping
+
+
+def write_uncompressed_maps(mapset):
+    """Write a 1 byte CELL map "bytes" and a FCELL map "floats" with the
+    region of elevation, and return the values of the CELL map."""
+    with open(str(mapset / "cellhd/elevation")) as f:
+        header = f.read().replace("compressed: 1", "compressed: 0")
+    values = [(x * 7 + y * 3) % 200 + 1 for y in range(320) for x in range(245)]
+
+    with open(str(mapset / "cellhd/bytes"), "w") as f:
+        f.write(header)
+    with open(str(mapset / "cell/bytes"), "wb") as f:
+        f.write(bytes(values))
+    os.makedirs(str(mapset / "cell_misc/bytes"))
+    with open(str(mapset / "cell_misc/bytes/range"), "w") as f:
+        f.write("1 200\n")
+
+    with open(str(mapset / "cellhd/floats"), "w") as f:
+        f.write(header.replace("format:     0", "format:     -1"))
+    open(str(mapset / "cell/floats"), "w").close()
+    os.makedirs(str(mapset / "fcell"))
+    with open(str(mapset / "fcell/floats"), "wb") as f:
+        f.write(struct.pack(">%df" % len(values), *[v / 4.0 for v in values]))
+    os.makedirs(str(mapset / "cell_misc/floats"))
+    with open(str(mapset / "cell_misc/floats/f_format"), "w") as f:
+        f.write("type: float\nbyte_order: xdr\n")
+
+    return values
+
+
+def test_grass_uncompressed_mapped(grass_location):
+    mapset = grass_location / "demomapset"
+    values = write_uncompressed_maps(mapset)
+    window = [values[y * 245 + x] for y in range(5, 12) for x in range(3, 33)]
+
+    mapped = {}
+    for name in ("bytes", "floats"):
+        band = gdal.Open(str(mapset / "cellhd" / name)).GetRasterBand(1)
+        mapped[name] = band.Checksum()
+        data = band.ReadRaster(3, 5, 30, 7)
+        if name == "bytes":
+            assert band.DataType == gdal.GDT_Byte
+            assert data == bytes(window)
+        else:
+            assert band.DataType == gdal.GDT_Float32
+            assert struct.unpack("%df" % len(window), data) == tuple(
+                v / 4.0 for v in window
+            )
+
+    # with a MASK hiding no cell the maps are read through libgrass
+    with open(str(mapset / "cellhd/MASK"), "w") as f:
+        f.write("reclass\nname: bytes\nmapset: demomapset\n#1\n")
+        f.write("1\n" * 200)
+    open(str(mapset / "cell/MASK"), "w").close()
+    for name in ("bytes", "floats"):
+        band = gdal.Open(str(mapset / "cellhd" / name)).GetRasterBand(1)
+        assert band.Checksum() == mapped[name]
+
+
+@pytest.mark.skipif(
+    not sys.platform.startswith("linux"), reason="virtual memory mapping"
+)
+def test_grass_uncompressed_virtual_mem(grass_location):
+    pytest.importorskip("numpy")
+    mapset = grass_location / "demomapset"
+    values = write_uncompressed_maps(mapset)
+
+    band = gdal.Open(str(mapset / "cellhd/bytes")).GetRasterBand(1)
+    array = band.GetVirtualMemAutoArray()
+    assert array.shape == (320, 245)
+    assert array.tobytes() == bytes(values)
+
+
+def test_grass_session_skips_env_switches():
+    ds = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    band = ds.GetRasterBand(1)
+    band.ReadRaster(0, 0, 10, 10)
+    switches = int(band.GetMetadataItem("ENV_SWITCHES", "_DEBUG_"))
+    skipped = int(band.GetMetadataItem("ENV_SWITCHES_SKIPPED", "_DEBUG_"))
+    band.ReadRaster(10, 10, 10, 10)
+    assert int(band.GetMetadataItem("ENV_SWITCHES", "_DEBUG_")) == switches
+    assert int(band.GetMetadataItem("ENV_SWITCHES_SKIPPED", "_DEBUG_")) > skipped
+
+
+@pytest.mark.skipif(sys.platform == "win32", reason="no worker processes")
+def test_grass_worker_processes():
+    path = "./data/small_grass_dataset/demomapset/cellhd/elevation"
+    ref = gdal.Open(path).GetRasterBand(1).ReadRaster()
+
+    with gdaltest.config_option("GDAL_NUM_THREADS", "2"):
+        ds = gdal.OpenEx(path, open_options=["WORKER_PROCESSES=YES"])
+        band = ds.GetRasterBand(1)
+        assert band.ReadRaster() == ref
+        assert band.ReadRaster(0, 0, 245, 320, 100, 80) == gdal.Open(
+            path
+        ).GetRasterBand(1).ReadRaster(0, 0, 245, 320, 100, 80)
+
+
+def test_grass_overviews(grass_location):
+    mapset = grass_location / "demomapset"
+    path = str(mapset / "cellhd/elevation")
+    ovr = str(mapset / "cell_misc/elevation/overviews.ovr")
+
+    assert gdal.Open(path).GetRasterBand(1).GetOverviewCount() == 0
+
+    ds = gdal.OpenEx(path, open_options=["OVERVIEWS=BUILD"])
+    band = ds.GetRasterBand(1)
+    assert band.GetOverviewCount() == 1
+    assert band.GetOverview(0).XSize == 123
+    assert os.path.exists(ovr)
+    ds = None
+
+    ds = gdal.Open(path)
+    assert ds.GetRasterBand(1).GetOverviewCount() == 1
+    ds = None
+
+    # outdated by a rewritten header, even with a newer overview file
+    mtime = os.stat(ovr).st_mtime
+    os.utime(path, (mtime - 10, mtime - 10))
+    os.utime(ovr, (mtime + 10, mtime + 10))
+    assert gdal.Open(path).GetRasterBand(1).GetOverviewCount() == 0
+
+    ds = gdal.OpenEx(path, open_options=["OVERVIEWS=BUILD"])
+    assert ds.GetRasterBand(1).GetOverviewCount() == 1
+    ds = None
+
+    # outdated by r.null within the second the overviews were built
+    null_file = str(mapset / "cell_misc/elevation/null")
+    with open(null_file, "wb") as f:
+        f.write(b"\xff" * ((245 + 7) // 8) * 320)
+    mtime = os.stat(ovr).st_mtime
+    os.utime(null_file, (mtime, mtime))
+    assert gdal.Open(path).GetRasterBand(1).GetOverviewCount() == 0
+
+    # gdaladdo records the maps as well
+    ds = gdal.Open(path)
+    assert ds.BuildOverviews("NEAREST", [2]) == gdal.CE_None
+    ds = None
+    assert gdal.Open(path).GetRasterBand(1).GetOverviewCount() == 1
+
+
+def test_grass_resampled_read():
+    ds = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    band = ds.GetRasterBand(1)
+    nodata = band.GetNoDataValue()
+
+    full = struct.unpack(
+        "d" * 40 * 40,
+        band.ReadRaster(100, 100, 40, 40, buf_type=gdal.GDT_Float64),
+    )
+    avg = struct.unpack(
+        "d" * 10 * 10,
+        band.ReadRaster(
+            100,
+            100,
+            40,
+            40,
+            10,
+            10,
+            buf_type=gdal.GDT_Float64,
+            resample_alg=gdal.GRIORA_Average,
+        ),
+    )
+    for j in range(10):
+        for i in range(10):
+            values = [
+                full[(4 * j + y) * 40 + 4 * i + x]
+                for y in range(4)
+                for x in range(4)
+                if full[(4 * j + y) * 40 + 4 * i + x] != nodata
+            ]
+            expected = sum(values) / len(values) if values else nodata
+            assert avg[j * 10 + i] == pytest.approx(expected)
+
+    def cancel(pct, msg, user_data):
+        return 0
+
+    with pytest.raises(Exception, match="User terminated"):
+        band.ReadRaster(
+            0,
+            0,
+            245,
+            320,
+            100,
+            80,
+            resample_alg=gdal.GRIORA_Bilinear,
+            callback=cancel,
+        )
+
+
+def test_grass_cubic_read_near_nulls(grass_location):
+    mapset = grass_location / "demomapset"
+    path = str(mapset / "cellhd/elevation")
+
+    # column 120 null
+    with open(str(mapset / "cell_misc/elevation/null"), "wb") as f:
+        f.write((b"\x00" * 15 + b"\x80" + b"\x00" * 15) * 320)
+
+    band = gdal.Open(path).GetRasterBand(1)
+    cubic, bilinear = (
+        struct.unpack(
+            "d" * 40 * 20,
+            band.ReadRaster(
+                110,
+                100,
+                20,
+                10,
+                40,
+                20,
+                buf_type=gdal.GDT_Float64,
+                resample_alg=alg,
+            ),
+        )
+        for alg in (gdal.GRIORA_Cubic, gdal.GRIORA_Bilinear)
+    )
+
+    # output column 20 is centered at 119.75, where the only valid cubic
+    # taps weigh 0.13: it falls back to bilinear instead of amplifying them
+    for j in range(20):
+        assert cubic[j * 40 + 20] == pytest.approx(bilinear[j * 40 + 20])
+        assert 3 <= cubic[j * 40 + 20] <= 27
+
+
+def test_grass_null_file_mask(grass_location):
+    mapset = grass_location / "demomapset"
+    path = str(mapset / "cellhd/elevation")
+    assert gdal.Open(path).GetRasterBand(1).GetMaskFlags() == gdal.GMF_NODATA
+
+    # first cell null, one bit per cell and rows padded to bytes
+    nulls = bytearray(320 * 31)
+    nulls[0] = 0x80
+    with open(str(mapset / "cell_misc/elevation/null"), "wb") as f:
+        f.write(nulls)
+
+    band = gdal.Open(path).GetRasterBand(1)
+    assert band.GetMaskFlags() == 0
+    assert band.GetMaskBand().ReadRaster(0, 0, 2, 1) == b"\x00\xff"
+
+
+def test_grass_group_interleaved_read(grass_location):
+    group = make_group(
+        grass_location / "demomapset", "twice", ["elevation", "elevation"]
+    )
+
+    ds = gdal.Open(str(group))
+    assert ds.RasterCount == 2
+    band = struct.unpack(
+        "i" * 25 * 20,
+        ds.GetRasterBand(1).ReadRaster(
+            10, 20, 50, 40, 25, 20, buf_type=gdal.GDT_Int32
+        ),
+    )
+
+    bip = struct.unpack(
+        "i" * 2 * 25 * 20,
+        ds.ReadRaster(
+            10,
+            20,
+            50,
+            40,
+            25,
+            20,
+            buf_type=gdal.GDT_Int32,
+            buf_pixel_space=8,
+            buf_line_space=8 * 25,
+            buf_band_space=4,
+        ),
+    )
+    assert bip[0::2] == band
+    assert bip[1::2] == band
+    bsq = struct.unpack(
+        "i" * 2 * 25 * 20,
+        ds.ReadRaster(10, 20, 50, 40, 25, 20, buf_type=gdal.GDT_Int32),
+    )
+    assert bsq == band + band
+
+
+def test_grass_advise_read_prefetch():
+    ds = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    band = ds.GetRasterBand(1)
+    expected = band.ReadRaster(20, 30, 100, 150)
+
+    ds = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    band = ds.GetRasterBand(1)
+    assert band.AdviseRead(20, 30, 100, 150) == gdal.CE_None
+    assert band.ReadRaster(20, 30, 100, 150) == expected
+    assert int(band.GetMetadataItem("PREFETCHED_ROWS", "_DEBUG_")) > 0
+
+
+def test_grass_prefetch_shared_budget(grass_location):
+    mapset = grass_location / "demomapset"
+    group = make_group(mapset, "many", ["elevation"] * 6)
+    ref = gdal.Open(str(mapset / "cellhd/elevation")).GetRasterBand(1)
+    ref = [ref.ReadBlock(0, y) for y in range(320)]
+
+    # the bands of a block by block copy compete for a single thread
+    with gdal.config_option("GRASS_PREFETCH_THREADS", "1"), gdal.config_option(
+        "GRASS_PREFETCH_MB", "1"
+    ):
+        ds = gdal.Open(str(group))
+        bands = [ds.GetRasterBand(i + 1) for i in range(ds.RasterCount)]
+        for y in range(320):
+            for band in bands:
+                assert band.ReadBlock(0, y) == ref[y]
+        prefetched = [
+            int(band.GetMetadataItem("PREFETCHED_ROWS", "_DEBUG_")) for band in bands
+        ]
+        assert max(prefetched) > 0
+        ds = None
+
+
+def test_grass_statistics_file(grass_location):
+    mapset = grass_location / "demomapset"
+
+    ds = gdal.Open(str(mapset / "cellhd/elevation"))
+    band = ds.GetRasterBand(1)
+    assert band.ComputeRasterMinMax(False) == (
+        band.GetMinimum(),
+        band.GetMaximum(),
+    )
+    stats = band.GetStatistics(False, True)
+    assert (mapset / "cell_misc/elevation/gdal_statistics").exists()
+
+    ds = gdal.Open(str(mapset / "cellhd/elevation"))
+    assert ds.GetRasterBand(1).GetStatistics(False, False) == stats
+
+    # r.null within the second the statistics were saved
+    row_bytes = (245 + 7) // 8
+    null_file = str(mapset / "cell_misc/elevation/null")
+    with open(null_file, "wb") as f:
+        f.write(b"\xff" * row_bytes * 100 + b"\0" * row_bytes * 220)
+    mtime = os.stat(str(mapset / "cell_misc/elevation/gdal_statistics")).st_mtime
+    os.utime(null_file, (mtime, mtime))
+
+    ds = gdal.Open(str(mapset / "cellhd/elevation"))
+    assert ds.GetRasterBand(1).GetStatistics(False, False) != stats
+    assert ds.GetRasterBand(1).GetStatistics(False, True) != stats
+
+
+@pytest.mark.parametrize("native", ["NO", "YES"])
+def test_grass_parallel_histogram(native):
+    ds = gdal.OpenEx(
+        "./data/small_grass_dataset/demomapset/cellhd/elevation",
+        open_options=["NATIVE_DECODER=" + native],
+    )
+    band = ds.GetRasterBand(1)
+    nodata = band.GetNoDataValue()
+    values = [
+        v
+        for v in struct.unpack(
+            "d" * ds.RasterXSize * ds.RasterYSize,
+            band.ReadRaster(buf_type=gdal.GDT_Float64),
+        )
+        if v != nodata
+    ]
+
+    expected = [0] * 10
+    for v in values:
+        expected[min(int((v - 0.0) / 25.5), 9)] += 1
+
+    with gdal.config_option("GDAL_NUM_THREADS", "4"):
+        hist = band.GetHistogram(
+            0.0, 255.0, 10, include_out_of_range=True, approx_ok=False
+        )
+    assert hist == expected
+
+
+def test_grass_parallel_histogram_progress():
+    ds = gdal.OpenEx(
+        "./data/small_grass_dataset/demomapset/cellhd/elevation",
+        open_options=["NATIVE_DECODER=YES"],
+    )
+    band = ds.GetRasterBand(1)
+    expected = band.GetHistogram(0.0, 30.0, 30, approx_ok=False)
+
+    progress = []
+
+    def callback(complete, message, data):
+        progress.append(complete)
+        return 1
+
+    with gdal.config_option("GDAL_NUM_THREADS", "4"):
+        hist = band.GetHistogram(0.0, 30.0, 30, approx_ok=False, callback=callback)
+    assert hist == expected
+
+    # the rows of all the threads are reported, in order
+    assert len(progress) > 2
+    assert progress == sorted(progress)
+    assert progress[-1] == 1.0
+
+
+def test_grass_group_manifest(grass_location):
+    group = make_group(
+        grass_location / "demomapset", "twice", ["elevation", "elevation"]
+    )
+
+    ds = gdal.OpenEx(str(group), open_options=["GROUP_MANIFEST=BUILD"])
+    expected = [
+        (b.DataType, b.GetNoDataValue(), b.Checksum())
+        for b in (ds.GetRasterBand(1), ds.GetRasterBand(2))
+    ]
+    ds = None
+    assert (group / "gdal_manifest").exists()
+
+    ds = gdal.Open(str(group))
+    assert [
+        (b.DataType, b.GetNoDataValue(), b.Checksum())
+        for b in (ds.GetRasterBand(1), ds.GetRasterBand(2))
+    ] == expected
+    ds = None
+
+    # elevation rewritten as a 4 byte map with negative values within the
+    # second the manifest was written
+    mapset = grass_location / "demomapset"
+    with open(str(mapset / "cellhd/elevation")) as f:
+        header = f.read()
+    with open(str(mapset / "cellhd/elevation"), "w") as f:
+        f.write(
+            header.replace("format:     0", "format:     3").replace(
+                "compressed: 1", "compressed: 0"
+            )
+        )
+    with open(str(mapset / "cell/elevation"), "wb") as f:
+        f.write(struct.pack(">I", 0x80000005) * (245 * 320))
+    with open(str(mapset / "cell_misc/elevation/range"), "w") as f:
+        f.write("-5 -5\n")
+    mtime = os.stat(str(group / "gdal_manifest")).st_mtime
+    for name in ("cellhd/elevation", "cell/elevation"):
+        os.utime(str(mapset / name), (mtime, mtime))
+
+    ds = gdal.Open(str(group))
+    assert ds.GetRasterBand(1).DataType == gdal.GDT_Int32
+    assert ds.GetRasterBand(1).ComputeRasterMinMax(False) == (-5, -5)
+
+
+def test_grass_identify():
+    drv = gdal.IdentifyDriver(
+        "./data/small_grass_dataset/demomapset/cellhd/elevation"
+    )
+    assert drv is not None and drv.ShortName == "GRASS"
+
+    drv = gdal.IdentifyDriver(
+        "./data/small_grass_dataset/demomapset/cell_misc/elevation/range"
+    )
+    assert drv is None or drv.ShortName != "GRASS"
+
+
+def test_grass_mapset_subdatasets(grass_location):
+    mapset = grass_location / "demomapset"
+
+    ds = gdal.Open("GRASS:" + str(mapset))
+    subdatasets = ds.GetMetadata("SUBDATASETS")
+    assert subdatasets == {
+        "SUBDATASET_1_NAME": str(mapset / "cellhd/elevation"),
+        "SUBDATASET_1_DESC": "Raster map elevation@demomapset",
+    }
+    ds = None
+
+    group = make_group(mapset, "twice", ["elevation", "elevation"])
+
+    ds = gdal.Open("GRASS:" + str(mapset))
+    subdatasets = ds.GetMetadata("SUBDATASETS")
+    assert subdatasets["SUBDATASET_2_NAME"] == str(group)
+    assert subdatasets["SUBDATASET_2_DESC"] == "Imagery group twice@demomapset"
+    assert gdal.Open(subdatasets["SUBDATASET_2_NAME"]).RasterCount == 2
+
+
+def test_grass_shared_row_cache():
+    path = "./data/small_grass_dataset/demomapset/cellhd/elevation"
+    with gdal.config_option("GRASS_ROW_CACHE_MB", "8"):
+        band = gdal.Open(path).GetRasterBand(1)
+        ref = band.ReadRaster(0, 0, 245, 40)
+        hits = int(band.GetMetadataItem("ROW_CACHE_HITS", "_DEBUG_"))
+
+        band = gdal.Open(path).GetRasterBand(1)
+        assert band.ReadRaster(0, 0, 245, 40) == ref
+        hits_after = int(band.GetMetadataItem("ROW_CACHE_HITS", "_DEBUG_"))
+        assert hits_after >= hits + 40
+
+    with gdal.config_option("GRASS_ROW_CACHE_MB", "0"):
+        band = gdal.Open(path).GetRasterBand(1)
+        hits = int(band.GetMetadataItem("ROW_CACHE_HITS", "_DEBUG_"))
+        assert band.ReadRaster(0, 0, 245, 40) == ref
+        assert int(band.GetMetadataItem("ROW_CACHE_HITS", "_DEBUG_")) == hits
+
+
+def test_grass_handle_pool_eviction(grass_location):
+    mapset = grass_location / "demomapset"
+    copy_map(mapset, "elevation", "elevation_2")
+    group = make_group(mapset, "pair", ["elevation", "elevation_2"])
+    ref = gdal.Open(str(mapset / "cellhd/elevation")).GetRasterBand(1)
+    ref = [ref.ReadRaster(0, y, 245, 1) for y in range(320)]
+
+    with gdal.config_option("GRASS_ROW_CACHE_MB", "0"), gdal.config_option(
+        "GRASS_MAX_OPEN_RASTERS", "1"
+    ):
+        ds = gdal.Open(str(group))
+        other = gdal.Open(str(mapset / "cellhd/elevation_2"))
+        bands = [ds.GetRasterBand(1), ds.GetRasterBand(2), other.GetRasterBand(1)]
+        misses = int(bands[0].GetMetadataItem("HANDLE_POOL_MISSES", "_DEBUG_"))
+
+        # every read takes the handle of the previously read band
+        for y in range(320):
+            for band in bands:
+                assert band.ReadRaster(0, y, 245, 1) == ref[y]
+
+        evicted = int(bands[0].GetMetadataItem("HANDLE_POOL_MISSES", "_DEBUG_"))
+        assert evicted > misses + len(bands)
+
+        ds.FlushCache()
+        other.FlushCache()
+        assert [band.Checksum() for band in bands] == [41487] * 3
+
+
+def test_grass_row_cache_null_file(grass_location):
+    mapset = grass_location / "demomapset"
+    path = str(mapset / "cellhd/elevation")
+    null_file = str(mapset / "cell_misc/elevation/null")
+    row_bytes = (245 + 7) // 8
+
+    # uncompressed null file without null cell
+    with open(null_file, "wb") as f:
+        f.write(b"\0" * row_bytes * 320)
+    checksum = gdal.Open(path).GetRasterBand(1).Checksum()
+    assert checksum == 41487
+
+    # r.null rewrites the null file with the same size, within the second
+    # of the previous read for fast scripts, hence the forced time stamp
+    with open(null_file, "wb") as f:
+        f.write(b"\xff" * row_bytes * 10 + b"\0" * row_bytes * 310)
+    mtime = os.stat(null_file).st_mtime + 10
+    os.utime(null_file, (mtime, mtime))
+    assert gdal.Open(path).GetRasterBand(1).Checksum() != checksum
+
+
+def test_grass_srs_cache(grass_location):
+    mapset = grass_location / "demomapset"
+    copy_map(mapset, "elevation", "elevation_2")
+
+    ds = gdal.Open(str(mapset / "cellhd/elevation"))
+    hits = int(ds.GetRasterBand(1).GetMetadataItem("SRS_CACHE_HITS", "_DEBUG_"))
+    other = gdal.Open(str(mapset / "cellhd/elevation_2"))
+    band = other.GetRasterBand(1)
+    assert int(band.GetMetadataItem("SRS_CACHE_HITS", "_DEBUG_")) > hits
+    assert other.GetSpatialRef().IsSame(ds.GetSpatialRef())
+    nad83 = ds.GetSpatialRef().GetAttrValue("DATUM")
+
+    # the same location moved to WGS 84, with a newer time stamp as the
+    # modification time of files has a resolution of a second
+    proj_info = grass_location / "PERMANENT/PROJ_INFO"
+    with open(str(proj_info)) as f:
+        lines = f.read().splitlines()
+    replaced = {
+        "datum": "wgs84",
+        "ellps": "wgs84",
+        "es": "0.0066943799901",
+        "f": "298.257223563",
+    }
+    with open(str(proj_info), "w") as f:
+        for line in lines:
+            key = line.split(":")[0]
+            if key == "towgs84":
+                continue
+            if key in replaced:
+                line = "%s: %s" % (key, replaced[key])
+            f.write(line + "\n")
+    mtime = os.stat(str(proj_info)).st_mtime + 10
+    os.utime(str(proj_info), (mtime, mtime))
+
+    srs = gdal.Open(str(mapset / "cellhd/elevation")).GetSpatialRef()
+    assert not srs.IsSame(ds.GetSpatialRef())
+    assert srs.GetAttrValue("DATUM") != nad83
+    assert srs.GetUTMZone() == 18
+
+
+def test_grass_row_cache_scans(grass_location):
+    path = str(grass_location / "demomapset/cellhd/elevation")
+
+    def cached_bytes():
+        return int(band.GetMetadataItem("ROW_CACHE_BYTES", "_DEBUG_"))
+
+    with gdal.config_option("GRASS_ROW_CACHE_MB", "8"), gdal.config_option(
+        "GRASS_DIRECT_IO_KB", "1"
+    ):
+        band = gdal.Open(path).GetRasterBand(1)
+        before = cached_bytes()
+
+        # rows read once by scans are not kept
+        band.GetHistogram(approx_ok=0)
+        assert band.ReadRaster() == gdal.Open(path).GetRasterBand(1).ReadRaster()
+        assert cached_bytes() == before
+
+        band.ReadBlock(0, 0)
+        assert cached_bytes() > before
+
+
+def test_grass_row_cache_mask(grass_location):
+    mapset = grass_location / "demomapset"
+    path = str(mapset / "cellhd/elevation")
+    unmasked = gdal.Open(path).GetRasterBand(1).Checksum()
+
+    # MASK of the cells of elevation 15 and more, as written by r.mask
+    with open(str(mapset / "cellhd/MASK"), "w") as f:
+        f.write("reclass\nname: elevation\nmapset: demomapset\n#3\n")
+        for value in range(3, 28):
+            f.write("*\n" if value < 15 else "1\n")
+    open(str(mapset / "cell/MASK"), "w").close()
+
+    masked = gdal.Open(path).GetRasterBand(1).Checksum()
+    assert masked != unmasked
+
+    os.remove(str(mapset / "cellhd/MASK"))
+    os.remove(str(mapset / "cell/MASK"))
+    assert gdal.Open(path).GetRasterBand(1).Checksum() == unmasked
+
+
+def test_grass_direct_io():
+    path = "./data/small_grass_dataset/demomapset/cellhd/elevation"
+    band = gdal.Open(path).GetRasterBand(1)
+    ref = band.ReadRaster()
+
+    def direct_io_bytes():
+        return int(band.GetMetadataItem("DIRECT_IO_BYTES", "_DEBUG_"))
+
+    with gdal.config_option("GRASS_DIRECT_IO_KB", "1"):
+        before = direct_io_bytes()
+        assert band.ReadRaster() == ref
+        assert direct_io_bytes() == before + len(ref)
+
+    with gdal.config_option("GRASS_DIRECT_IO_KB", "1000000"):
+        before = direct_io_bytes()
+        assert band.ReadRaster() == ref
+        assert direct_io_bytes() == before
+
+
+@pytest.mark.parametrize("native", ["NO", "YES"])
+def test_grass_narrowing_kernels(grass_location, native):
+    # 4 byte CELL map, big endian sign and magnitude, with values below 0
+    # and above 65535 and no 0, which would be null without null file
+    mapset = grass_location / "demomapset"
+    values = [
+        (x * 997 + y * 1361) % 210001 - 70000 or 1
+        for y in range(320)
+        for x in range(245)
+    ]
+    with open(str(mapset / "cellhd/elevation")) as f:
+        header = f.read()
+    with open(str(mapset / "cellhd/wide"), "w") as f:
+        f.write(
+            header.replace("format:     0", "format:     3").replace(
+                "compressed: 1", "compressed: 0"
+            )
+        )
+    with open(str(mapset / "cell/wide"), "wb") as f:
+        for v in values:
+            f.write(struct.pack(">I", v if v >= 0 else 0x80000000 | -v))
+    os.makedirs(str(mapset / "cell_misc/wide"))
+    with open(str(mapset / "cell_misc/wide/range"), "w") as f:
+        f.write("%d %d\n" % (min(values), max(values)))
+
+    ds = gdal.OpenEx(
+        str(mapset / "cellhd/wide"), open_options=["NATIVE_DECODER=" + native]
+    )
+    band = ds.GetRasterBand(1)
+    assert band.DataType == gdal.GDT_Int32
+
+    with gdal.config_option("GRASS_DIRECT_IO_KB", "1"):
+        data = band.ReadRaster()
+        assert struct.unpack("%di" % len(values), data) == tuple(values)
+
+        # reference conversions by GDALCopyWords
+        ref = gdal.GetDriverByName("MEM").Create("", 245, 320, 1, gdal.GDT_Int32)
+        ref.GetRasterBand(1).WriteRaster(0, 0, 245, 320, data)
+
+        before = int(band.GetMetadataItem("DIRECT_IO_BYTES", "_DEBUG_"))
+        for buf_type, fmt in ((gdal.GDT_Byte, "B"), (gdal.GDT_UInt16, "H")):
+            size = struct.calcsize(fmt)
+            for xoff, width in ((0, 245), (5, 37), (11, 45)):
+                expected = ref.GetRasterBand(1).ReadRaster(
+                    xoff, 3, width, 50, buf_type=buf_type
+                )
+                got = band.ReadRaster(xoff, 3, width, 50, buf_type=buf_type)
+                assert got == expected
+
+                strided = band.ReadRaster(
+                    xoff,
+                    3,
+                    width,
+                    50,
+                    buf_type=buf_type,
+                    buf_pixel_space=2 * size,
+                    buf_line_space=2 * size * width,
+                )
+                count = width * 50
+                got = struct.unpack("%d%s" % (2 * count, fmt), strided)[0::2]
+                assert got == struct.unpack("%d%s" % (count, fmt), expected)
+        assert int(band.GetMetadataItem("DIRECT_IO_BYTES", "_DEBUG_")) > before
+
+
+@pytest.mark.parametrize("row_order", ["TOP_DOWN", "COARSE_TO_FINE"])
+def test_grass_async_reader(row_order):
+    ds = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    expected = ds.ReadRaster(10, 20, 200, 280, 100, 140)
+
+    ar = ds.BeginAsyncReader(
+        10,
+        20,
+        200,
+        280,
+        buf_xsize=100,
+        buf_ysize=140,
+        options=["ROW_ORDER=" + row_order],
+    )
+    rows = 0
+    while True:
+        res = ar.GetNextUpdatedRegion(-1)
+        if res[0] == gdal.GARIO_UPDATE or res[0] == gdal.GARIO_COMPLETE:
+            assert res[3] in (0, 100)
+            rows += res[4]
+        if res[0] != gdal.GARIO_UPDATE:
+            break
+    assert res[0] == gdal.GARIO_COMPLETE
+    assert rows >= 140
+    assert bytes(ar.GetBuffer()) == expected
+    ds.EndAsyncReader(ar)
+
+
+def test_grass_reclass_native_decoder(grass_location):
+    mapset = grass_location / "demomapset"
+    with open(str(mapset / "cellhd/elevation_class"), "w") as f:
+        f.write("reclass\nname: elevation\nmapset: demomapset\n#3\n")
+        for value in range(3, 28):
+            f.write("*\n" if value == 27 else "%d\n" % (value // 10 + 1))
+    open(str(mapset / "cell/elevation_class"), "w").close()
+
+    path = str(mapset / "cellhd/elevation_class")
+    ref = gdal.OpenEx(path, open_options=["NATIVE_DECODER=NO"])
+    ds = gdal.OpenEx(path, open_options=["NATIVE_DECODER=YES"])
+    assert ds.GetRasterBand(1).ReadRaster() == ref.GetRasterBand(1).ReadRaster()
+    assert ds.GetRasterBand(1).ReadRaster(
+        10, 20, 50, 40, 25, 20
+    ) == ref.GetRasterBand(1).ReadRaster(10, 20, 50, 40, 25, 20)
+
+
+###############################################################################
+# Category labels as raster attribute table and category names
+
+
+def test_grass_category_labels(grass_location):
+    mapset = grass_location / "demomapset"
+    os.makedirs(str(mapset / "cats"), exist_ok=True)
+    with open(str(mapset / "cats/elevation"), "w") as f:
+        f.write("# 3 categories\nTitle\n\n0.00 0.00 0.00 0.00\n")
+        f.write("3:low\n10:mid\n20:high\n")
+
+    ds = gdal.Open(str(mapset / "cellhd/elevation"))
+    band = ds.GetRasterBand(1)
+    rat = band.GetDefaultRAT()
+    assert rat is not None
+    assert rat.GetRowCount() == 3
+    assert rat.GetNameOfCol(0) == "Value"
+    assert rat.GetUsageOfCol(1) == gdal.GFU_Name
+    assert rat.GetValueAsString(rat.GetRowOfValue(10), 1) == "mid"
+    assert rat.GetRowOfValue(11) == -1
+
+    # the value index follows changes to the table
+    rat.SetValueAsInt(1, 0, 11)
+    assert rat.GetRowOfValue(11) == 1
+    assert rat.GetRowOfValue(10) == -1
+    rat.SetRowCount(4)
+    rat.SetValueAsInt(3, 0, 12)
+    assert rat.GetRowOfValue(12) == 3
+    assert band.GetDefaultRAT().GetRowOfValue(3) == 0
+
+    names = band.GetCategoryNames()
+    assert len(names) == 21
+    assert names[3] == "low" and names[20] == "high" and names[4] == ""
+
+    ds = gdal.Open("./data/small_grass_dataset/demomapset/cellhd/elevation")
+    assert ds.GetRasterBand(1).GetDefaultRAT() is None
+
+
+###############################################################################
+# Space time raster datasets as multidimensional arrays
+
+
+def test_grass_strds_multidim(grass_location):
+    sqlite3 = pytest.importorskip("sqlite3")
+    if gdal.GetDriverByName("SQLite") is None:
+        pytest.skip("SQLite driver missing")
+
+    location = grass_location
+    mapset = location / "demomapset"
+    for name in ("elevation_1", "elevation_2"):
+        copy_map(mapset, name="elevation", new_name=name)
+
+    os.makedirs(str(location / "PERMANENT/tgis"))
+    db = sqlite3.connect(str(location / "PERMANENT/tgis/sqlite.db"))
+    db.executescript(
+        """
+        CREATE TABLE strds (id VARCHAR, name VARCHAR, mapset VARCHAR,
+                            temporal_type VARCHAR);
+        CREATE TABLE strds_metadata (id VARCHAR, raster_register VARCHAR);
+        CREATE TABLE raster_base (id VARCHAR, name VARCHAR, mapset VARCHAR);
+        CREATE TABLE raster_absolute_time (id VARCHAR, start_time TIMESTAMP);
+        CREATE TABLE raster_metadata (id VARCHAR, datatype VARCHAR);
+        CREATE TABLE raster_map_register_1 (id VARCHAR);
+        INSERT INTO strds VALUES ('daily@demomapset', 'daily', 'demomapset',
+                                  'absolute');
+        INSERT INTO strds_metadata VALUES ('daily@demomapset',
+                                           'raster_map_register_1');
+        """
+    )
+    maps = (("elevation_2", "2024-01-02"), ("elevation_1", "2024-01-01"))
+    for name, time in maps:
+        map_id = name + "@demomapset"
+        db.execute(
+            "INSERT INTO raster_base VALUES (?, ?, ?)", (map_id, name, "demomapset")
+        )
+        db.execute("INSERT INTO raster_absolute_time VALUES (?, ?)", (map_id, time))
+        db.execute("INSERT INTO raster_metadata VALUES (?, 'CELL')", (map_id,))
+        db.execute("INSERT INTO raster_map_register_1 VALUES (?)", (map_id,))
+    db.commit()
+    db.close()
+
+    ds = gdal.OpenEx("GRASS:" + str(mapset), gdal.OF_MULTIDIM_RASTER)
+    rg = ds.GetRootGroup()
+    assert rg.GetMDArrayNames() == ["daily"]
+    ar = rg.OpenMDArray("daily")
+    assert [dim.GetSize() for dim in ar.GetDimensions()] == [2, 320, 245]
+    times = ar.GetDimensions()[0].GetIndexingVariable().Read()
+    assert struct.unpack("2d", times) == (1704067200, 1704153600)
+
+    # null cells are CELL nulls in the array, the band nodata value in the band
+    nodata = struct.unpack("i", ar.GetNoDataValueAsRaw())[0]
+    ref = gdal.Open(str(mapset / "cellhd/elevation")).GetRasterBand(1)
+    ref_data = struct.unpack(
+        "%di" % (320 * 245), ref.ReadRaster(buf_type=gdal.GDT_Int32)
+    )
+    data = struct.unpack(
+        "%di" % (320 * 245), ar.Read(array_start_idx=[1, 0, 0], count=[1, 320, 245])
+    )
+    assert [0 if v == nodata else v for v in data] == list(ref_data)
+
+    # time series at one cell
+    series = ar.Read(array_start_idx=[0, 50, 100], count=[2, 1, 1])
+    assert struct.unpack("2i", series) == (data[50 * 245 + 100],) * 2
+
+    # with a single open map the maps are closed and reopened in turn
+    with gdal.config_option("GRASS_MAX_OPEN_RASTERS", "1"):
+        for y in (10, 200, 10):
+            series = ar.Read(array_start_idx=[0, y, 0], count=[2, 1, 245])
+            row = data[y * 245 : (y + 1) * 245]
+            assert struct.unpack("490i", series) == row + row
@@ -15,13 +15,40 @@
  *
  ****************************************************************************/
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstring>
-
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_frmts.h"
 #include "gdal_priv.h"
+#include "gdal_rat.h"
 #include "ogr_spatialref.h"
+#include "ogrsf_frmts.h"
+
+#include "grasskernels.h"
+#include "grassnative.h"
+#include "grassprefetch.h"
+#include "grassresample.h"
+#include "grassrowcache.h"
+#include "grasssession.h"
+#include "grassstats.h"
+#include "grassworkers.h"
 
 extern "C"
 {
@@ -46,25 +73,10 @@ extern "C"
 enum
 {
     BUFF_SIZE = 200,
-    GRASS_MAX_COLORS = 100000
+    GRASS_MAX_COLORS = 100000,
+    GRASS_AUTO_BLOCK_BYTES = 1024 * 1024
 };
 
-/************************************************************************/
-/*                         Grass2CPLErrorHook()                         */
-/************************************************************************/
-
-static auto Grass2CPLErrorHook(char *pszMessage, int bFatal) -> int
-{
-    if (!bFatal)
-        //CPLDebug( "GRASS", "%s", pszMessage );
-        CPLError(CE_Warning, CPLE_AppDefined, "GRASS warning: %s", pszMessage);
-    else
-        CPLError(CE_Warning, CPLE_AppDefined, "GRASS fatal error: %s",
-                 pszMessage);
-
-    return 0;
-}
-
 struct GRASSRasterPath
 {
     std::string gisdbase;
@@ -86,19 +98,54 @@ struct GRASSRasterPath
 
 class GRASSRasterBand;
 
+/* Header information of a map which a band is set up from, read by
+ * GRASSRasterBand::ReadInfo() or from the group manifest. */
+struct GRASSBandInfo
+{
+    int nGRSType{CELL_TYPE};
+    int nFormat{0}; /* bytes per cell - 1 of CELL maps */
+    int nCompressed{0};
+    bool bHaveMinMax{false};
+    double dfMin{0.0};
+    double dfMax{0.0};
+    bool bMapRegion{false}; /* the map region is the dataset region */
+};
+
 class GRASSDataset final : public GDALDataset
 {
     friend class GRASSRasterBand;
+    friend class GRASSNullMaskBand;
+    friend class GRASSAsyncReader;
+    friend class GRASSSTRDSArray;
 
     std::string osGisdbase;
     std::string osLocation; /* LOCATION_NAME */
     std::string osElement;  /* cellhd or group */
 
+    int nBlockYSizeRequest{1}; /* BLOCK_YSIZE open option, 0 for AUTO */
+    bool bNativeDecoder{false}; /* NATIVE_DECODER open option */
+    bool bWorkerProcesses{false}; /* WORKER_PROCESSES open option */
+
+    /* Overviews are kept in cell_misc/<name>/ (group/<name>/ for a group)
+     * with the stamp of the maps they were built from, in overviews.stamp,
+     * and only used while the maps are unchanged. */
+    std::string osOverviewDir{};
+    std::string osOverviewFile{};
+    bool bBuildOverviews{false}; /* OVERVIEWS=BUILD open option */
+    bool bOverviewsChecked{false};
+    bool bOverviewsUsable{false};
+
+    /* The band headers of a group are cached in group/<name>/gdal_manifest,
+     * used while the group and its maps are unchanged. */
+    std::string osGroupDir{};
+    bool bUseManifest{false};   /* GROUP_MANIFEST=USE or BUILD */
+    bool bBuildManifest{false}; /* GROUP_MANIFEST=BUILD */
+
     struct Cell_head sCellInfo
     {
     }; /* raster region */
 
-    OGRSpatialReference m_oSRS{};
+    OGRSpatialReference *m_poSRS{nullptr}; /* shared, see GRASSSession */
 
 #if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 12, 0)
     GDALGeoTransform m_gt{};
@@ -108,6 +155,7 @@ class GRASSDataset final : public GDALDataset
 
   public:
     explicit GRASSDataset(GRASSRasterPath &);
+    ~GRASSDataset() override;
 
     auto GetSpatialRef() const -> const OGRSpatialReference * override;
 
@@ -117,7 +165,35 @@ class GRASSDataset final : public GDALDataset
     auto GetGeoTransform(double *) -> CPLErr override;
 #endif
 
+    auto IRasterIO(GDALRWFlag, int, int, int, int, void *, int, int,
+                   GDALDataType, int, BANDMAP_TYPE, GSpacing, GSpacing,
+                   GSpacing, GDALRasterIOExtraArg *) -> CPLErr override;
+
+    auto BeginAsyncReader(int, int, int, int, void *, int, int, GDALDataType,
+                          int, int *, int, int, int, char **)
+        -> GDALAsyncReader * override;
+
+    static auto Identify(GDALOpenInfo *) -> int;
     static auto Open(GDALOpenInfo *) -> GDALDataset *;
+
+  protected:
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 6, 0)
+    auto IBuildOverviews(const char *, int, const int *, int, const int *,
+                         GDALProgressFunc, void *, CSLConstList)
+        -> CPLErr override;
+#else
+    auto IBuildOverviews(const char *, int, int *, int, int *,
+                         GDALProgressFunc, void *) -> CPLErr override;
+#endif
+
+  private:
+    auto GetSourceStamp() -> std::string;
+    auto GetOverviewStampFile() const -> std::string;
+    auto GetManifestHeader() -> std::string;
+    auto ReadManifest(char **, char **, std::vector<GRASSBandInfo> &) -> bool;
+    void WriteManifest(char **, char **, const std::vector<GRASSBandInfo> &);
+    auto PrepareOverviews() -> bool;
+    auto BuildInternalOverviews() -> bool;
 };
 
 /************************************************************************/
@@ -126,9 +202,15 @@ class GRASSDataset final : public GDALDataset
 /* ==================================================================== */
 /************************************************************************/
 
+class GRASSNullMaskBand;
+class GRASSCategoryTable;
+
 class GRASSRasterBand final : public GDALRasterBand
 {
     friend class GRASSDataset;
+    friend class GRASSNullMaskBand;
+    friend class GRASSAsyncReader;
+    friend class GRASSSTRDSArray;
 
     std::string osCellName;
     std::string osMapset;
@@ -136,10 +218,53 @@ class GRASSRasterBand final : public GDALRasterBand
     int nGRSType;      // GRASS raster type: CELL_TYPE, FCELL_TYPE, DCELL_TYPE
     bool nativeNulls;  // use GRASS native NULL values
 
+    // in-driver decoder, reads rows instead of libgrass if bNativeRows,
+    // also opened to memory map uncompressed maps. Opened on first read,
+    // see PrepareReading().
+    std::unique_ptr<GRASSNativeRaster> poNative{};
+    bool bNativeRows{false};
+    bool bNativeChecked{false};
+    bool bReadingPrepared{false};
+    int nCompressed{0};
+
+    // row read by IReadBlock() and IRasterIO() before conversion
+    std::vector<GByte> abyRowScratch{};
+
+    // map part of the keys of the rows in the shared row cache, set by
+    // PrepareReading()
+    GRASSRowCache::Key oRowCacheKey{};
+
+    // reclass maps read by the in-driver decoder: rows of the base map
+    // looked up in the reclass table, see OpenReclass()
+    std::unique_ptr<GRASSNativeRaster> poReclassBase{};
+    std::vector<CELL> anReclassTable{};
+    CELL nReclassMin{0};
+    GRASSRowCache::Key oBaseRowCacheKey{};
+
+    // rows of the region decoded in advance, see AdviseRead()
+    std::unique_ptr<GRASSRowPrefetcher> poPrefetcher{};
+    std::vector<GByte> abyPrefetchRow{};
+    int nLastBlockYOff{-1};
+    int nSequentialBlocks{0};
+    GUIntBig nPrefetchedRows{0};
+
+    // mask band read from the null file, see GetMaskBand()
+    std::unique_ptr<GRASSNullMaskBand> poNullMask{};
+    bool bNullMaskChecked{false};
+
+    // read on first use, see LoadColors()
     struct Colors sGrassColors
     {
     };
-    GDALColorTable *poCT;
+    bool bColorsLoaded{false};
+    bool bHaveColors{false};
+    bool bColorRulesSet{false};
+    std::unique_ptr<GDALColorTable> poCT{};
+
+    // read on first use, see LoadCategories()
+    bool bCategoriesLoaded{false};
+    std::unique_ptr<GRASSCategoryTable> poRAT{};
+    CPLStringList aosCategoryNames{};
 
     struct Cell_head sOpenWindow
     {
@@ -149,12 +274,32 @@ class GRASSRasterBand final : public GDALRasterBand
     double dfCellMin{0.0};
     double dfCellMax{0.0};
 
+    // read in the region of the map, the statistics kept in the support
+    // files of the map describe the band
+    bool bMapRegion{false};
+
     double dfNoData;
 
     bool valid{false};
 
+    /* The pool of bands holding an open raster handle (most recently
+     * used first). GRASS maps every open raster to the current window, so
+     * a handle stays valid across window changes. Handles are closed when
+     * the pool is full or another location takes over the (process
+     * global) GRASS state. Protected by the GRASSSession lock. */
+    static std::list<GRASSRasterBand *> oHandlePool;
+    static GUIntBig nHandlePoolHits;
+    static GUIntBig nHandlePoolMisses;
+    std::list<GRASSRasterBand *>::iterator oHandlePoolPos{};
+
+    /* Process wide counters of the requests read past the block cache,
+     * see UseDirectIO() */
+    static std::atomic<GUIntBig> nDirectIORequests;
+    static std::atomic<GUIntBig> nDirectIOBytes;
+
   public:
-    GRASSRasterBand(GRASSDataset *, int, std::string &, std::string &);
+    GRASSRasterBand(GRASSDataset *, int, const std::string &,
+                    const std::string &, const GRASSBandInfo &);
     ~GRASSRasterBand() override;
 
     auto IReadBlock(int, int, void *) -> CPLErr override;
@@ -163,886 +308,4892 @@ class GRASSRasterBand final : public GDALRasterBand
                    GDALRasterIOExtraArg *psExtraArg) -> CPLErr override;
     auto GetColorInterpretation() -> GDALColorInterp override;
     auto GetColorTable() -> GDALColorTable * override;
+    auto GetDefaultRAT() -> GDALRasterAttributeTable * override;
+    auto GetCategoryNames() -> char ** override;
     auto GetMinimum(int *pbSuccess = nullptr) -> double override;
     auto GetMaximum(int *pbSuccess = nullptr) -> double override;
+    auto ComputeRasterMinMax(int, double *) -> CPLErr override;
+    auto GetStatistics(int bApproxOK, int bForce, double *pdfMin,
+                       double *pdfMax, double *pdfMean, double *pdfStdDev)
+        -> CPLErr override;
+    auto GetDefaultHistogram(double *pdfMin, double *pdfMax, int *pnBuckets,
+                             GUIntBig **ppanHistogram, int bForce,
+                             GDALProgressFunc, void *pProgressData)
+        -> CPLErr override;
+    auto GetHistogram(double dfMin, double dfMax, int nBuckets,
+                      GUIntBig *panHistogram, int bIncludeOutOfRange,
+                      int bApproxOK, GDALProgressFunc, void *pProgressData)
+        -> CPLErr override;
     auto GetNoDataValue(int *pbSuccess = nullptr) -> double override;
+    auto GetMetadata(const char *pszDomain = "") -> char ** override;
+    auto GetMetadataItem(const char *pszName, const char *pszDomain = "")
+        -> const char * override;
+    auto GetVirtualMemAuto(GDALRWFlag eRWFlag, int *pnPixelSpace,
+                           GIntBig *pnLineSpace, char **papszOptions)
+        -> CPLVirtualMem * override;
+    auto GetOverviewCount() -> int override;
+    auto GetOverview(int) -> GDALRasterBand * override;
+    auto GetMaskBand() -> GDALRasterBand * override;
+    auto GetMaskFlags() -> int override;
+    auto AdviseRead(int, int, int, int, int, int, GDALDataType, char **)
+        -> CPLErr override;
+
+    static void ReleaseHandles(const std::string &, const std::string &);
+    static void ReadInfo(const std::string &, const std::string &,
+                         const struct Cell_head *, GRASSBandInfo *);
 
   private:
+    void PrepareReading();
+    void OpenReclass();
+    auto ReadNativeRow(const struct Cell_head &, int, void *,
+                       bool bKeep = true) -> bool;
+    auto OpenNative() -> GRASSNativeRaster *;
+    auto LoadColors() -> bool;
+    void LoadCategories();
+    void SetColorRules();
+    auto HasNullMask() -> bool;
+    auto GetMiscDir() -> std::string;
+    auto GetMapMTime() -> GIntBig;
+    auto GetMapStamp() -> std::string;
+    auto HasMapRange() -> bool;
+    auto ReadMapStatistics(double *) -> bool;
+    auto ReadStatisticsFile(double *) -> bool;
+    void WriteStatisticsFile(const double *);
+    auto ScanRows(GRASSRowStatistics &, GDALProgressFunc, void *) -> CPLErr;
+    void StartPrefetch(int, int);
+    auto TakePrefetchedRow(int, int, int, void *) -> bool;
     void SetWindow(struct Cell_head *);
     auto ResetReading(struct Cell_head *) -> CPLErr;
+    auto BeginRead(struct Cell_head *) -> CPLErr;
+    auto ReadGRASSRow(struct Cell_head *, int, void *, bool bKeep = true)
+        -> CPLErr;
+    auto GetMappedData() -> const GByte *;
+    auto ResampledRasterIO(int, int, int, int, void *, int, int, GDALDataType,
+                           GSpacing, GSpacing, GDALRasterIOExtraArg *)
+        -> CPLErr;
+    auto UseWorkers(const struct Cell_head *, int) -> bool;
+    auto UseDirectIO(int, int, int, int, int) -> bool;
+    void CountDirectIO(int, int, GDALDataType);
+    auto ReadRowsInWorkers(const struct Cell_head *, int, int,
+                           const GRASSWorkerPool::RowHandler &) -> CPLErr;
+    static auto GetWorkerPool() -> GRASSWorkerPool *;
+    auto OpenRaster() -> CPLErr;
+    void CloseRaster();
 };
 
 /************************************************************************/
-/*                          GRASSRasterBand()                           */
+/* ==================================================================== */
+/*                           GRASSNullMaskBand                          */
+/* ==================================================================== */
 /************************************************************************/
-GRASSRasterBand::GRASSRasterBand(GRASSDataset *poDSIn, int nBandIn,
-                                 std::string &pszMapsetIn,
-                                 std::string &pszCellNameIn)
-    : osCellName(pszCellNameIn), osMapset(pszMapsetIn),
-      nGRSType(Rast_map_type(osCellName.c_str(), osMapset.c_str()))
-{
-    struct Cell_head sCellInfo
-    {
-    };
-
-    // Note: GISDBASE, LOCATION_NAME ans MAPSET was set in GRASSDataset::Open
-
-    this->poDS = poDSIn;
-    this->nBand = nBandIn;
 
-    Rast_get_cellhd(osCellName.c_str(), osMapset.c_str(), &sCellInfo);
-
-    /* -------------------------------------------------------------------- */
-    /*      Get min/max values.                                             */
-    /* -------------------------------------------------------------------- */
-    struct FPRange sRange
-    {
-    };
+/* Mask band of a GRASSRasterBand read from the null bits of the map, the
+ * data rows are not decoded. */
+class GRASSNullMaskBand final : public GDALRasterBand
+{
+    GRASSRasterBand *poParent;
 
-    if (Rast_read_fp_range(osCellName.c_str(), osMapset.c_str(), &sRange) == -1)
-    {
-        bHaveMinMax = FALSE;
-    }
-    else
-    {
-        bHaveMinMax = TRUE;
-        Rast_get_fp_range_min_max(&sRange, &dfCellMin, &dfCellMax);
-    }
+  public:
+    explicit GRASSNullMaskBand(GRASSRasterBand *);
 
-    /* -------------------------------------------------------------------- */
-    /*      Setup band type, and preferred nodata value.                    */
-    /* -------------------------------------------------------------------- */
-    // Negative values are also (?) stored as 4 bytes (format = 3)
-    //       => raster with format < 3 has only positive values
+    auto IReadBlock(int, int, void *) -> CPLErr override;
+};
 
-    // GRASS modules usually do not waste space and only the format necessary to keep
-    // full raster values range is used -> no checks if shorter type could be used
+/************************************************************************/
+/* ==================================================================== */
+/*                          GRASSCategoryTable                          */
+/* ==================================================================== */
+/************************************************************************/
 
-    if (nGRSType == CELL_TYPE)
-    {
-        if (sCellInfo.format == 0)
-        {  // 1 byte / cell -> possible range 0,255
-            if (bHaveMinMax && dfCellMin > 0)
-            {
-                this->eDataType = GDT_Byte;
-                dfNoData = 0.0;
-            }
-            else if (bHaveMinMax && dfCellMax < 255)
-            {
-                this->eDataType = GDT_Byte;
-                dfNoData = 255.0;
-            }
-            else
-            {  // maximum is not known or full range is used
-                this->eDataType = GDT_UInt16;
-                dfNoData = 256.0;
-            }
-            nativeNulls = false;
-        }
-        else if (sCellInfo.format == 1)
-        {  // 2 bytes / cell -> possible range 0,65535
-            if (bHaveMinMax && dfCellMin > 0)
-            {
-                this->eDataType = GDT_UInt16;
-                dfNoData = 0.0;
-            }
-            else if (bHaveMinMax && dfCellMax < 65535)
-            {
-                this->eDataType = GDT_UInt16;
-                dfNoData = 65535;
-            }
-            else
-            {  // maximum is not known or full range is used
-                CELL cval = 0;
-                this->eDataType = GDT_Int32;
-                Rast_set_c_null_value(&cval, 1);
-                dfNoData = (double)cval;
-            }
-            nativeNulls = false;
-        }
-        else
-        {  // 3-4 bytes
-            CELL cval = 0;
-            this->eDataType = GDT_Int32;
-            Rast_set_c_null_value(&cval, 1);
-            dfNoData = (double)cval;
-            nativeNulls = true;
-        }
-    }
-    else if (nGRSType == FCELL_TYPE)
-    {
-        FCELL fval = NAN;
-        this->eDataType = GDT_Float32;
-        Rast_set_f_null_value(&fval, 1);
-        dfNoData = (double)fval;
-        nativeNulls = true;
-    }
-    else if (nGRSType == DCELL_TYPE)
-    {
-        DCELL dval = NAN;
-        this->eDataType = GDT_Float64;
-        Rast_set_d_null_value(&dval, 1);
-        dfNoData = (double)dval;
-        nativeNulls = true;
-    }
+/* Raster attribute table of the category labels of a CELL map, with a
+ * hash index of the rows of single value categories so that value
+ * lookups do not scan the table. Modifying the table through
+ * GetDefaultRAT() drops the index, lookups then use the default scan. */
+class GRASSCategoryTable final : public GDALDefaultRasterAttributeTable
+{
+    std::unordered_map<CELL, int> oRowOfValue{};
+    bool bHaveRanges{false};
+    bool bIndexed{false};
 
-    nBlockXSize = poDSIn->nRasterXSize;
-    nBlockYSize = 1;
+    void DropIndex();
 
-    Rast_set_window(&(poDSIn->sCellInfo));
-    // open the raster only for actual reading
-    hCell = -1;
-    memcpy(static_cast<void *>(&sOpenWindow),
-           static_cast<void *>(&(poDSIn->sCellInfo)), sizeof(struct Cell_head));
+  public:
+    void BuildIndex();
 
-    /* -------------------------------------------------------------------- */
-    /*      Do we have a color table?                                       */
-    /* -------------------------------------------------------------------- */
-    poCT = nullptr;
-    if (Rast_read_colors(osCellName.c_str(), osMapset.c_str(), &sGrassColors) ==
-        1)
-    {
-        int maxcolor = 0;
-        CELL min = 0, max = 0;
+    using GDALDefaultRasterAttributeTable::GetRowOfValue;
+    auto GetRowOfValue(double dfValue) const -> int override;
 
-        Rast_get_c_color_range(&min, &max, &sGrassColors);
+    using GDALDefaultRasterAttributeTable::SetValue;
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 11, 0)
+    auto SetValue(int iRow, int iField, const char *pszValue)
+        -> CPLErr override;
+    auto SetValue(int iRow, int iField, int nValue) -> CPLErr override;
+    auto SetValue(int iRow, int iField, double dfValue) -> CPLErr override;
+#else
+    void SetValue(int iRow, int iField, const char *pszValue) override;
+    void SetValue(int iRow, int iField, int nValue) override;
+    void SetValue(int iRow, int iField, double dfValue) override;
+#endif
+    void SetRowCount(int nCount) override;
+    auto SetLinearBinning(double dfRow0Min, double dfBinSize)
+        -> CPLErr override;
+};
 
-        if (bHaveMinMax)
-        {
-            if (max < dfCellMax)
-            {
-                maxcolor = max;
-            }
-            else
-            {
-                maxcolor = (int)ceil(dfCellMax);
-            }
-            if (maxcolor > GRASS_MAX_COLORS)
-            {
-                maxcolor = GRASS_MAX_COLORS;
-                CPLDebug("GRASS",
-                         "Too many values, color table cut to %d entries.",
-                         maxcolor);
-            }
-        }
-        else
-        {
-            if (max < GRASS_MAX_COLORS)
-            {
-                maxcolor = max;
-            }
-            else
-            {
-                maxcolor = GRASS_MAX_COLORS;
-                CPLDebug("GRASS",
-                         "Too many values, color table set to %d entries.",
-                         maxcolor);
-            }
-        }
+/************************************************************************/
+/* ==================================================================== */
+/*                          GRASSMapsetDataset                          */
+/* ==================================================================== */
+/************************************************************************/
 
-        poCT = new GDALColorTable();
-        for (int iColor = 0; iColor <= maxcolor; iColor++)
-        {
-            int nRed = 0, nGreen = 0, nBlue = 0;
-            GDALColorEntry sColor;
+/* GRASS:<gisdbase>/<location>/<mapset> catalog, lists the raster maps and
+ * imagery groups of the mapset as subdatasets, and its space time raster
+ * datasets as arrays of the multidimensional root group. */
+class GRASSMapsetDataset final : public GDALDataset
+{
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
+    std::shared_ptr<GDALGroup> poRootGroup{};
+#endif
 
-            if (Rast_get_c_color(&iColor, &nRed, &nGreen, &nBlue,
-                                 &sGrassColors))
-            {
-                sColor.c1 = (short)nRed;
-                sColor.c2 = (short)nGreen;
-                sColor.c3 = (short)nBlue;
-                sColor.c4 = 255;
+  public:
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
+    auto GetRootGroup() const -> std::shared_ptr<GDALGroup> override;
+#endif
 
-                poCT->SetColorEntry(iColor, &sColor);
-            }
-            else
-            {
-                sColor.c1 = 0;
-                sColor.c2 = 0;
-                sColor.c3 = 0;
-                sColor.c4 = 0;
+    static auto Open(GDALOpenInfo *) -> GDALDataset *;
+};
 
-                poCT->SetColorEntry(iColor, &sColor);
-            }
-        }
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
 
-        /* Create metadata entries for color table rules */
-        std::array<char, BUFF_SIZE> value{};
-        std::array<char, BUFF_SIZE> key{};
-        int rcount = Rast_colors_count(&sGrassColors);
+/************************************************************************/
+/* ==================================================================== */
+/*                           GRASSMapsetGroup                           */
+/* ==================================================================== */
+/************************************************************************/
 
-        (void)std::snprintf(value.data(), BUFF_SIZE, "%d", rcount);
-        this->SetMetadataItem("COLOR_TABLE_RULES_COUNT", value.data());
+class GRASSSTRDSArray;
 
-        /* Add the rules in reverse order */
-        for (int i = rcount - 1; i >= 0; i--)
-        {
-            DCELL val1 = NAN, val2 = NAN;
-            unsigned char r1 = 0, g1 = 0, b1 = 0, r2 = 0, g2 = 0, b2 = 0;
-
-            Rast_get_fp_color_rule(&val1, &r1, &g1, &b1, &val2, &r2, &g2, &b2,
-                                   &sGrassColors, i);
-
-            (void)std::snprintf(key.data(), key.size(),
-                                "COLOR_TABLE_RULE_RGB_%d", rcount - i - 1);
-            (void)std::snprintf(value.data(), value.size(),
-                                "%e %e %d %d %d %d %d %d", val1, val2, r1, g1,
-                                b1, r2, g2, b2);
-            this->SetMetadataItem(key.data(), value.data());
-        }
-    }
-    else
-    {
-        this->SetMetadataItem("COLOR_TABLE_RULES_COUNT", "0");
-    }
+/* Root group of a mapset, the space time raster datasets of the mapset
+ * registered in the temporal database, opened on request and kept. */
+class GRASSMapsetGroup final : public GDALGroup
+{
+    std::string osGisdbase;
+    std::string osLocation;
+    std::string osMapset;
+    bool bNativeDecoder;
+    GDALDatasetUniquePtr poTemporalDB;
+    std::vector<std::string> aosSTRDS{};
+    mutable std::map<std::string, std::shared_ptr<GRASSSTRDSArray>>
+        oArrays{};
 
-    this->valid = true;
-}
+  public:
+    GRASSMapsetGroup(const std::string &osGisdbase,
+                     const std::string &osLocation,
+                     const std::string &osMapset, bool bNativeDecoder);
+
+    auto GetMDArrayNames(CSLConstList papszOptions = nullptr) const
+        -> std::vector<std::string> override;
+    auto OpenMDArray(const std::string &osName,
+                     CSLConstList papszOptions = nullptr) const
+        -> std::shared_ptr<GDALMDArray> override;
+};
 
 /************************************************************************/
-/*                          ~GRASSRasterBand()                          */
+/* ==================================================================== */
+/*                           GRASSSTRDSArray                            */
+/* ==================================================================== */
 /************************************************************************/
 
-GRASSRasterBand::~GRASSRasterBand()
+/* A space time raster dataset (STRDS) read from the temporal database */
+struct GRASSSTRDSInfo
 {
-    if (poCT != nullptr)
+    struct Map
     {
-        Rast_free_colors(&sGrassColors);
-        delete poCT;
-    }
+        std::string osName;
+        std::string osMapset;
+        double dfTime; /* start, seconds since 1970 or in osUnit */
+    };
 
-    if (hCell >= 0)
-        Rast_close(hCell);
-}
+    std::string osName;
+    bool bAbsolute{true};
+    std::string osUnit{}; /* of relative times */
+    GDALDataType eType{GDT_Int32};
+    std::vector<Map> asMaps{};
+};
 
-/************************************************************************/
-/*                             SetWindow                                */
-/*                                                                      */
-/* Helper for ResetReading                                              */
-/* close the current GRASS raster band, actually set the new window,    */
-/* reset GRASS variables                                                */
-/*                                                                      */
-/* Returns nothing                       */
-/************************************************************************/
-void GRASSRasterBand::SetWindow(struct Cell_head *sNewWindow)
+/* A STRDS as a (time, y, x) array in the region of its first map. The
+ * band of a map is set up on its first read and kept, so that a map is
+ * not opened again for each read; rows are shared through the row
+ * cache. At most GRASS_MAX_OPEN_RASTERS bands are kept, least recently
+ * read ones are closed first. */
+class GRASSSTRDSArray final : public GDALMDArray
 {
-    if (hCell >= 0)
-    {
-        Rast_close(hCell);
-        hCell = -1;
-    }
+    std::string osFilename;
+    GRASSSTRDSInfo sInfo;
+    GDALExtendedDataType oType;
+    double dfNoData;
+    std::vector<GByte> abyNoData{};
+    std::vector<std::shared_ptr<GDALDimension>> apoDims{};
+    std::vector<std::shared_ptr<GDALMDArray>> apoIndexingVars{};
+    std::shared_ptr<OGRSpatialReference> poSRS{};
 
-    /* Set window */
-    Rast_set_window(sNewWindow);
+    /* region and open options of the maps, the bands are not its own */
+    std::unique_ptr<GRASSDataset> poGridDS;
+    mutable std::vector<std::unique_ptr<GRASSRasterBand>> apoSlices{};
+    mutable std::list<size_t> anOpenSlices{}; /* most recently read first */
 
-    /* Set GRASS env to the current raster, don't open the raster */
-    G_setenv_nogisrc("GISDBASE",
-                     (dynamic_cast<GRASSDataset *>(poDS))->osGisdbase.c_str());
-    G_setenv_nogisrc("LOCATION_NAME",
-                     (dynamic_cast<GRASSDataset *>(poDS))->osLocation.c_str());
-    G_setenv_nogisrc("MAPSET", osMapset.c_str());
-    G_reset_mapsets();
-    G_add_mapset_to_search_path(osMapset.c_str());
-}
+    GRASSSTRDSArray(const std::string &osParentName,
+                    const std::string &osFilename, GRASSSTRDSInfo &&sInfo,
+                    std::unique_ptr<GRASSDataset> poGridDS);
 
-/************************************************************************/
-/*                             ResetReading                             */
-/*                                                                      */
-/* Reset current window for a new reading request,                      */
-/* close the current GRASS raster band, reset GRASS variables           */
-/*                                                                      */
-/* Returns CE_Failure if fails, otherwise CE_None                       */
-/************************************************************************/
-auto GRASSRasterBand::ResetReading(struct Cell_head *sNewWindow) -> CPLErr
-{
+    auto GetSlice(size_t) const -> GRASSRasterBand *;
+
+  protected:
+    auto IRead(const GUInt64 *arrayStartIdx, const size_t *count,
+               const GInt64 *arrayStep, const GPtrDiff_t *bufferStride,
+               const GDALExtendedDataType &bufferDataType,
+               void *pDstBuffer) const -> bool override;
 
-    /* Check if the window has changed */
-    if (sNewWindow->north != sOpenWindow.north ||
-        sNewWindow->south != sOpenWindow.south ||
-        sNewWindow->east != sOpenWindow.east ||
-        sNewWindow->west != sOpenWindow.west ||
-        sNewWindow->ew_res != sOpenWindow.ew_res ||
-        sNewWindow->ns_res != sOpenWindow.ns_res ||
-        sNewWindow->rows != sOpenWindow.rows ||
-        sNewWindow->cols != sOpenWindow.cols)
+  public:
+    static auto Create(const std::string &osParentName,
+                       const std::string &osFilename,
+                       const std::string &osGisdbase,
+                       const std::string &osLocation, bool bNativeDecoder,
+                       GRASSSTRDSInfo &&sInfo)
+        -> std::shared_ptr<GRASSSTRDSArray>;
+
+    auto IsWritable() const -> bool override
     {
-        SetWindow(sNewWindow);
-        memcpy(static_cast<void *>(&sOpenWindow),
-               static_cast<void *>(sNewWindow), sizeof(struct Cell_head));
+        return false;
     }
-    else
+
+    auto GetFilename() const -> const std::string & override
     {
-        /* The windows are identical, check current window */
-        struct Cell_head sCurrentWindow
-        {
-        };
+        return osFilename;
+    }
+
+    auto GetDimensions() const
+        -> const std::vector<std::shared_ptr<GDALDimension>> & override
+    {
+        return apoDims;
+    }
 
-        Rast_get_window(&sCurrentWindow);
+    auto GetDataType() const -> const GDALExtendedDataType & override
+    {
+        return oType;
+    }
 
-        if (sNewWindow->north != sCurrentWindow.north ||
-            sNewWindow->south != sCurrentWindow.south ||
-            sNewWindow->east != sCurrentWindow.east ||
-            sNewWindow->west != sCurrentWindow.west ||
-            sNewWindow->ew_res != sCurrentWindow.ew_res ||
-            sNewWindow->ns_res != sCurrentWindow.ns_res ||
-            sNewWindow->rows != sCurrentWindow.rows ||
-            sNewWindow->cols != sCurrentWindow.cols)
-        {
-            SetWindow(sNewWindow);
-        }
+    auto GetRawNoDataValue() const -> const void * override
+    {
+        return abyNoData.data();
     }
 
-    return CE_None;
-}
+    auto GetSpatialRef() const
+        -> std::shared_ptr<OGRSpatialReference> override
+    {
+        return poSRS;
+    }
+};
 
 /************************************************************************/
-/*                             IReadBlock()                             */
-/*                                                                      */
+/* ==================================================================== */
+/*                            GRASSTimeArray                            */
+/* ==================================================================== */
+/************************************************************************/
+
+/* Start times of the maps of a STRDS, indexing variable of its time
+ * dimension. */
+class GRASSTimeArray final : public GDALMDArray
+{
+    std::string osFilename;
+    std::vector<double> adfTimes;
+    std::string osUnit;
+    GDALExtendedDataType oType{GDALExtendedDataType::Create(GDT_Float64)};
+    std::vector<std::shared_ptr<GDALDimension>> apoDims;
+    std::vector<std::shared_ptr<GDALAttribute>> apoAttributes{};
+
+  protected:
+    auto IRead(const GUInt64 *arrayStartIdx, const size_t *count,
+               const GInt64 *arrayStep, const GPtrDiff_t *bufferStride,
+               const GDALExtendedDataType &bufferDataType,
+               void *pDstBuffer) const -> bool override;
+
+  public:
+    GRASSTimeArray(const std::string &osParentName,
+                   const std::string &osFilename,
+                   const std::shared_ptr<GDALDimension> &poDim,
+                   std::vector<double> &&adfTimes, bool bAbsolute,
+                   const std::string &osUnit);
+
+    auto IsWritable() const -> bool override
+    {
+        return false;
+    }
+
+    auto GetFilename() const -> const std::string & override
+    {
+        return osFilename;
+    }
+
+    auto GetDimensions() const
+        -> const std::vector<std::shared_ptr<GDALDimension>> & override
+    {
+        return apoDims;
+    }
+
+    auto GetDataType() const -> const GDALExtendedDataType & override
+    {
+        return oType;
+    }
+
+    auto GetUnit() const -> const std::string & override
+    {
+        return osUnit;
+    }
+
+    auto GetAttributes(CSLConstList /* papszOptions */ = nullptr) const
+        -> std::vector<std::shared_ptr<GDALAttribute>> override
+    {
+        return apoAttributes;
+    }
+};
+
+#endif /* GDAL_VERSION_NUM >= 3.8 */
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           GRASSAsyncReader                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/* Decodes the rows of a window into the caller's buffer in a background
+ * thread, see GRASSDataset::BeginAsyncReader(). */
+class GRASSAsyncReader final : public GDALAsyncReader
+{
+    /* first row step of ROW_ORDER=COARSE_TO_FINE */
+    static constexpr int COARSE_STEP = 16;
+
+    struct Cell_head sWindow
+    {
+    };
+    std::vector<GRASSRasterBand *> apoBands{};
+    bool bCoarseToFine{false};
+    bool bAllNative{true};
+
+    /* held while rows are copied into the buffer, see LockBuffer() */
+    std::timed_mutex oBufferMutex{};
+
+    /* all below protected by oMutex */
+    std::mutex oMutex{};
+    std::condition_variable oCond{};
+    int nUpdatedFirstRow{-1}; /* buffer rows written since the last */
+    int nUpdatedLastRow{-1};  /* GetNextUpdatedRegion(), -1 if none */
+    bool bDone{false};
+    bool bFailed{false};
+    bool bStop{false};
+
+    std::thread oThread{};
+
+    void Run();
+    auto ReadRow(int, std::vector<std::vector<GByte>> &) -> bool;
+    void CopyRows(int, int, std::vector<std::vector<GByte>> &);
+
+  public:
+    GRASSAsyncReader(GRASSDataset *, const std::vector<GRASSRasterBand *> &,
+                     bool bCoarseToFine, int, int, int, int, void *, int, int,
+                     GDALDataType, int, int, int);
+    ~GRASSAsyncReader() override;
+
+    void Start();
+
+    auto GetNextUpdatedRegion(double, int *, int *, int *, int *)
+        -> GDALAsyncStatusType override;
+    auto LockBuffer(double) -> int override;
+    void UnlockBuffer() override;
+};
+
+std::list<GRASSRasterBand *> GRASSRasterBand::oHandlePool;
+GUIntBig GRASSRasterBand::nHandlePoolHits = 0;
+GUIntBig GRASSRasterBand::nHandlePoolMisses = 0;
+std::atomic<GUIntBig> GRASSRasterBand::nDirectIORequests{0};
+std::atomic<GUIntBig> GRASSRasterBand::nDirectIOBytes{0};
+
+/************************************************************************/
+/*                          GRASSRowDataType()                          */
+/*                                                                      */
+/* GDAL data type of the rows returned for a GRASS raster type.         */
+/************************************************************************/
+
+static auto GRASSRowDataType(int nGRSType) -> GDALDataType
+{
+    if (nGRSType == FCELL_TYPE)
+        return GDT_Float32;
+    if (nGRSType == DCELL_TYPE)
+        return GDT_Float64;
+    return GDT_Int32;
+}
+
+/************************************************************************/
+/*                            SameWindow()                              */
+/************************************************************************/
+
+static auto SameWindow(const struct Cell_head *psA, const struct Cell_head *psB)
+    -> bool
+{
+    return psA->north == psB->north && psA->south == psB->south &&
+           psA->east == psB->east && psA->west == psB->west &&
+           psA->ew_res == psB->ew_res && psA->ns_res == psB->ns_res &&
+           psA->rows == psB->rows && psA->cols == psB->cols;
+}
+
+/************************************************************************/
+/*                          GetReadWindow()                             */
+/*                                                                      */
+/* GRASS window of a RasterIO request on a dataset whose region is      */
+/* psDsWindow, with the rows and columns of the buffer.                 */
+/************************************************************************/
+
+static void GetReadWindow(const struct Cell_head *psDsWindow, int nXOff,
+                          int nYOff, int nXSize, int nYSize, int nBufXSize,
+                          int nBufYSize, struct Cell_head *psWindow)
+{
+    psWindow->north = psDsWindow->north - nYOff * psDsWindow->ns_res;
+    psWindow->south = psWindow->north - nYSize * psDsWindow->ns_res;
+    psWindow->west = psDsWindow->west + nXOff * psDsWindow->ew_res;
+    psWindow->east = psWindow->west + nXSize * psDsWindow->ew_res;
+    psWindow->proj = psDsWindow->proj;
+    psWindow->zone = psDsWindow->zone;
+
+    psWindow->cols = nBufXSize;
+    psWindow->rows = nBufYSize;
+
+    /* Reset resolution */
+    auto oLock = GRASSSession::Acquire();
+    G_adjust_Cell_head(psWindow, 1, 1);
+}
+
+/************************************************************************/
+/*                         GetMaxOpenRasters()                          */
+/************************************************************************/
+
+static auto GetMaxOpenRasters() -> int
+{
+    return std::max(1,
+                    atoi(CPLGetConfigOption("GRASS_MAX_OPEN_RASTERS", "64")));
+}
+
+/************************************************************************/
+/*                          GetMapFilesMTime()                          */
+/*                                                                      */
+/* Most recent modification time of the header, data and null files of */
+/* a map, -1 if the header or data file cannot be found. r.null only    */
+/* rewrites the null file.                                              */
+/************************************************************************/
+
+static auto GetMapFilesMTime(const std::string &osMapsetDir,
+                             const std::string &osName, int nGRSType)
+    -> GIntBig
+{
+    const std::string aosFiles[] = {
+        osMapsetDir + "/cellhd/" + osName,
+        osMapsetDir + (nGRSType == CELL_TYPE ? "/cell/" : "/fcell/") + osName,
+        osMapsetDir + "/cell_misc/" + osName + "/null",
+        osMapsetDir + "/cell_misc/" + osName + "/nullcmpr"};
+
+    GIntBig nMTime = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        VSIStatBufL sStat;
+        if (VSIStatL(aosFiles[i].c_str(), &sStat) != 0)
+        {
+            if (i < 2)
+                return -1;
+            continue;
+        }
+        nMTime = std::max(nMTime, static_cast<GIntBig>(sStat.st_mtime));
+    }
+
+    return nMTime;
+}
+
+/************************************************************************/
+/*                          GetMapFilesStamp()                          */
+/*                                                                      */
+/* Modification times and sizes of the header, data and null files of  */
+/* a map ("-1:-1" for a missing file), for the files derived from a map */
+/* to be used only while it is unchanged: unlike a comparison of        */
+/* modification times, it also tells apart a map rewritten within the   */
+/* second the derived file was written.                                 */
+/************************************************************************/
+
+static auto GetMapFilesStamp(const std::string &osMapsetDir,
+                             const std::string &osName, int nGRSType)
+    -> std::string
+{
+    const std::string aosFiles[] = {
+        osMapsetDir + "/cellhd/" + osName,
+        osMapsetDir + (nGRSType == CELL_TYPE ? "/cell/" : "/fcell/") + osName,
+        osMapsetDir + "/cell_misc/" + osName + "/null",
+        osMapsetDir + "/cell_misc/" + osName + "/nullcmpr"};
+
+    std::string osStamp;
+    for (const auto &osFile : aosFiles)
+    {
+        VSIStatBufL sStat;
+        if (!osStamp.empty())
+            osStamp += ' ';
+        if (VSIStatL(osFile.c_str(), &sStat) != 0)
+            osStamp += "-1:-1";
+        else
+            osStamp += CPLSPrintf(CPL_FRMT_GIB ":" CPL_FRMT_GIB,
+                                  static_cast<GIntBig>(sStat.st_mtime),
+                                  static_cast<GIntBig>(sStat.st_size));
+    }
+
+    return osStamp;
+}
+
+/************************************************************************/
+/*                           SetRowCacheMap()                           */
+/*                                                                      */
+/* Set the map part of a row cache key. Modification times have a       */
+/* resolution of one second, the size of the data and null files also  */
+/* tells apart a map rewritten within the same second. libgrass applies */
+/* the MASK of the mapset to the rows it reads (the in-driver decoder   */
+/* is not used then), so the MASK is part of the key too.               */
+/************************************************************************/
+
+static void SetRowCacheMap(GRASSRowCache::Key &oKey,
+                           const std::string &osMapsetDir,
+                           const std::string &osName, int nGRSType)
+{
+    oKey.osMap = osMapsetDir + "/" + osName;
+    oKey.nMTime = GetMapFilesMTime(osMapsetDir, osName, nGRSType);
+    oKey.nMapType = nGRSType;
+
+    oKey.nSize = 0;
+    const std::string aosFiles[] = {
+        osMapsetDir + (nGRSType == CELL_TYPE ? "/cell/" : "/fcell/") + osName,
+        osMapsetDir + "/cell_misc/" + osName + "/null",
+        osMapsetDir + "/cell_misc/" + osName + "/nullcmpr"};
+    for (const auto &osFile : aosFiles)
+    {
+        VSIStatBufL sStat;
+        if (VSIStatL(osFile.c_str(), &sStat) == 0)
+            oKey.nSize += static_cast<GIntBig>(sStat.st_size);
+    }
+
+    VSIStatBufL sStat;
+    const std::string osMask = osMapsetDir + "/cell/MASK";
+    oKey.nMaskMTime = VSIStatL(osMask.c_str(), &sStat) == 0
+                          ? static_cast<GIntBig>(sStat.st_mtime)
+                          : -1;
+}
+
+/************************************************************************/
+/*                         SetRowCacheWindow()                          */
+/*                                                                      */
+/* Complete the map part of a row cache key with a row of a window.     */
+/************************************************************************/
+
+static void SetRowCacheWindow(GRASSRowCache::Key &oKey,
+                              const struct Cell_head &sWindow, int nRow)
+{
+    oKey.dfNorth = sWindow.north;
+    oKey.dfSouth = sWindow.south;
+    oKey.dfEast = sWindow.east;
+    oKey.dfWest = sWindow.west;
+    oKey.nRows = sWindow.rows;
+    oKey.nCols = sWindow.cols;
+    oKey.nRow = nRow;
+}
+
+/************************************************************************/
+/*                           GetThreadCount()                           */
+/*                                                                      */
+/* GDAL_NUM_THREADS, a single thread if not set.                        */
+/************************************************************************/
+
+static auto GetThreadCount() -> int
+{
+    const char *pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if (pszThreads == nullptr)
+        return 1;
+    if (EQUAL(pszThreads, "ALL_CPUS"))
+        return CPLGetNumCPUs();
+    return std::max(1, atoi(pszThreads));
+}
+
+/************************************************************************/
+/*                          RasterIOProgress()                          */
+/*                                                                      */
+/* Report the progress of a RasterIO request, false if it was           */
+/* cancelled.                                                           */
+/************************************************************************/
+
+static auto RasterIOProgress(GDALRasterIOExtraArg *psExtraArg,
+                             double dfComplete) -> bool
+{
+    if (psExtraArg == nullptr || psExtraArg->pfnProgress == nullptr)
+        return true;
+
+    if (!psExtraArg->pfnProgress(dfComplete, "", psExtraArg->pProgressData))
+    {
+        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                              ReadInfo()                              */
+/*                                                                      */
+/* Read the header information a band is set up from.                   */
+/************************************************************************/
+void GRASSRasterBand::ReadInfo(const std::string &osMapsetIn,
+                               const std::string &osCellNameIn,
+                               const struct Cell_head *psDsWindow,
+                               GRASSBandInfo *psInfo)
+{
+    struct Cell_head sCellInfo
+    {
+    };
+
+    // Note: GISDBASE, LOCATION_NAME ans MAPSET was set in GRASSDataset::Open
+
+    psInfo->nGRSType = Rast_map_type(osCellNameIn.c_str(), osMapsetIn.c_str());
+
+    Rast_get_cellhd(osCellNameIn.c_str(), osMapsetIn.c_str(), &sCellInfo);
+    psInfo->nFormat = sCellInfo.format;
+    psInfo->nCompressed = sCellInfo.compressed;
+    psInfo->bMapRegion = SameWindow(&sCellInfo, psDsWindow);
+
+    /* -------------------------------------------------------------------- */
+    /*      Get min/max values.                                             */
+    /* -------------------------------------------------------------------- */
+    struct FPRange sRange
+    {
+    };
+
+    if (Rast_read_fp_range(osCellNameIn.c_str(), osMapsetIn.c_str(),
+                           &sRange) == -1)
+    {
+        psInfo->bHaveMinMax = false;
+    }
+    else
+    {
+        psInfo->bHaveMinMax = true;
+        Rast_get_fp_range_min_max(&sRange, &(psInfo->dfMin), &(psInfo->dfMax));
+    }
+}
+
+/************************************************************************/
+/*                          GRASSRasterBand()                           */
+/*                                                                      */
+/* Set up from the header information only, the map is not accessed    */
+/* until it is read.                                                    */
+/************************************************************************/
+GRASSRasterBand::GRASSRasterBand(GRASSDataset *poDSIn, int nBandIn,
+                                 const std::string &pszMapsetIn,
+                                 const std::string &pszCellNameIn,
+                                 const GRASSBandInfo &sInfo)
+    : osCellName(pszCellNameIn), osMapset(pszMapsetIn),
+      nGRSType(sInfo.nGRSType), nCompressed(sInfo.nCompressed),
+      bHaveMinMax(sInfo.bHaveMinMax), dfCellMin(sInfo.dfMin),
+      dfCellMax(sInfo.dfMax), bMapRegion(sInfo.bMapRegion)
+{
+    this->poDS = poDSIn;
+    this->nBand = nBandIn;
+
+    /* -------------------------------------------------------------------- */
+    /*      Setup band type, and preferred nodata value.                    */
+    /* -------------------------------------------------------------------- */
+    // Negative values are also (?) stored as 4 bytes (format = 3)
+    //       => raster with format < 3 has only positive values
+
+    // GRASS modules usually do not waste space and only the format necessary to keep
+    // full raster values range is used -> no checks if shorter type could be used
+
+    if (nGRSType == CELL_TYPE)
+    {
+        if (sInfo.nFormat == 0)
+        {  // 1 byte / cell -> possible range 0,255
+            if (bHaveMinMax && dfCellMin > 0)
+            {
+                this->eDataType = GDT_Byte;
+                dfNoData = 0.0;
+            }
+            else if (bHaveMinMax && dfCellMax < 255)
+            {
+                this->eDataType = GDT_Byte;
+                dfNoData = 255.0;
+            }
+            else
+            {  // maximum is not known or full range is used
+                this->eDataType = GDT_UInt16;
+                dfNoData = 256.0;
+            }
+            nativeNulls = false;
+        }
+        else if (sInfo.nFormat == 1)
+        {  // 2 bytes / cell -> possible range 0,65535
+            if (bHaveMinMax && dfCellMin > 0)
+            {
+                this->eDataType = GDT_UInt16;
+                dfNoData = 0.0;
+            }
+            else if (bHaveMinMax && dfCellMax < 65535)
+            {
+                this->eDataType = GDT_UInt16;
+                dfNoData = 65535;
+            }
+            else
+            {  // maximum is not known or full range is used
+                CELL cval = 0;
+                this->eDataType = GDT_Int32;
+                Rast_set_c_null_value(&cval, 1);
+                dfNoData = (double)cval;
+            }
+            nativeNulls = false;
+        }
+        else
+        {  // 3-4 bytes
+            CELL cval = 0;
+            this->eDataType = GDT_Int32;
+            Rast_set_c_null_value(&cval, 1);
+            dfNoData = (double)cval;
+            nativeNulls = true;
+        }
+    }
+    else if (nGRSType == FCELL_TYPE)
+    {
+        FCELL fval = NAN;
+        this->eDataType = GDT_Float32;
+        Rast_set_f_null_value(&fval, 1);
+        dfNoData = (double)fval;
+        nativeNulls = true;
+    }
+    else if (nGRSType == DCELL_TYPE)
+    {
+        DCELL dval = NAN;
+        this->eDataType = GDT_Float64;
+        Rast_set_d_null_value(&dval, 1);
+        dfNoData = (double)dval;
+        nativeNulls = true;
+    }
+
+    nBlockXSize = poDSIn->nRasterXSize;
+    if (poDSIn->nBlockYSizeRequest > 0)
+    {
+        nBlockYSize = poDSIn->nBlockYSizeRequest;
+    }
+    else
+    {
+        // AUTO: as many rows as fit in a small share of the block cache
+        const GIntBig nRowBytes = static_cast<GIntBig>(nBlockXSize) *
+                                  GDALGetDataTypeSizeBytes(eDataType);
+        const GIntBig nBudget = std::min<GIntBig>(GDALGetCacheMax64() / 64,
+                                                  GRASS_AUTO_BLOCK_BYTES);
+        nBlockYSize =
+            static_cast<int>(std::max<GIntBig>(1, nBudget / nRowBytes));
+    }
+    nBlockYSize = std::min(nBlockYSize, poDSIn->nRasterYSize);
+
+    GRASSSession::SetWindow(&(poDSIn->sCellInfo));
+    // open the raster only for actual reading
+    hCell = -1;
+
+    memcpy(static_cast<void *>(&sOpenWindow),
+           static_cast<void *>(&(poDSIn->sCellInfo)), sizeof(struct Cell_head));
+
+    this->valid = true;
+}
+
+/************************************************************************/
+/*                          ~GRASSRasterBand()                          */
+/************************************************************************/
+
+GRASSRasterBand::~GRASSRasterBand()
+{
+    poPrefetcher.reset();
+
+    auto oLock = GRASSSession::Acquire();
+    if (bColorsLoaded)
+        Rast_free_colors(&sGrassColors);
+    CloseRaster();
+}
+
+/************************************************************************/
+/*                             OpenRaster()                             */
+/*                                                                      */
+/* Take the raster handle from the pool, open the raster if it is not   */
+/* open yet. The handle stays open across reads and window changes      */
+/* until it is evicted from the pool or CloseRaster() is called.        */
+/************************************************************************/
+auto GRASSRasterBand::OpenRaster() -> CPLErr
+{
+    if (hCell >= 0)
+    {
+        nHandlePoolHits++;
+        oHandlePool.splice(oHandlePool.begin(), oHandlePool, oHandlePoolPos);
+        return CE_None;
+    }
+
+    nHandlePoolMisses++;
+
+    const size_t nMaxOpen = static_cast<size_t>(GetMaxOpenRasters());
+    while (oHandlePool.size() >= nMaxOpen)
+        oHandlePool.back()->CloseRaster();
+
+    hCell = Rast_open_old(osCellName.c_str(), osMapset.c_str());
+    if (hCell < 0)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "GRASS: Cannot open raster '%s'",
+                 osCellName.c_str());
+        return CE_Failure;
+    }
+    oHandlePoolPos = oHandlePool.insert(oHandlePool.begin(), this);
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                            CloseRaster()                             */
+/************************************************************************/
+void GRASSRasterBand::CloseRaster()
+{
+    if (hCell < 0)
+        return;
+
+    Rast_close(hCell);
+    hCell = -1;
+    oHandlePool.erase(oHandlePoolPos);
+}
+
+/************************************************************************/
+/*                           ReleaseHandles()                           */
+/*                                                                      */
+/* Close the raster handles of all bands which do not belong to the     */
+/* given GISDBASE/LOCATION_NAME. GRASS refuses to set a window while    */
+/* rasters in another projection or zone are open, so GRASSSession      */
+/* calls this before the GRASS environment is switched to another       */
+/* location, by either driver.                                          */
+/************************************************************************/
+void GRASSRasterBand::ReleaseHandles(const std::string &osGisdbase,
+                                     const std::string &osLocation)
+{
+    auto oBands = oHandlePool;
+    for (auto poBand : oBands)
+    {
+        auto poBandDS = dynamic_cast<GRASSDataset *>(poBand->poDS);
+        if (poBandDS->osGisdbase != osGisdbase ||
+            poBandDS->osLocation != osLocation)
+        {
+            poBand->CloseRaster();
+        }
+    }
+}
+
+/************************************************************************/
+/*                             SetWindow                                */
+/*                                                                      */
+/* Helper for ResetReading                                              */
+/* take over the GRASS state: reset GRASS variables and set the new     */
+/* window, GRASSSession skips what is already current                   */
+/*                                                                      */
+/* Returns nothing                       */
+/************************************************************************/
+void GRASSRasterBand::SetWindow(struct Cell_head *sNewWindow)
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    /* Set GRASS env to the current raster, don't open the raster */
+    GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+
+    /* Set window, open rasters of this location are remapped by GRASS */
+    GRASSSession::SetWindow(sNewWindow);
+}
+
+/************************************************************************/
+/*                             ResetReading                             */
+/*                                                                      */
+/* Reset current window for a new reading request,                      */
+/* close the current GRASS raster band, reset GRASS variables           */
+/*                                                                      */
+/* Returns CE_Failure if fails, otherwise CE_None                       */
+/************************************************************************/
+auto GRASSRasterBand::ResetReading(struct Cell_head *sNewWindow) -> CPLErr
+{
+
+    // another band or the vector driver may have changed the GRASS state
+    // in the meantime, an open raster is remapped to the new window
+    SetWindow(sNewWindow);
+    memcpy(static_cast<void *>(&sOpenWindow), static_cast<void *>(sNewWindow),
+           sizeof(struct Cell_head));
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                              BeginRead                               */
+/*                                                                      */
+/* Prepare reading rows of a window: the in-driver decoder needs no     */
+/* preparation, libgrass needs the window set and the raster open.      */
+/************************************************************************/
+auto GRASSRasterBand::BeginRead(struct Cell_head *sNewWindow) -> CPLErr
+{
+    if (bNativeRows)
+        return CE_None;
+
+    if (ResetReading(sNewWindow) != CE_None)
+        return CE_Failure;
+
+    // open for reading, the handle is kept for the following reads
+    return OpenRaster();
+}
+
+/************************************************************************/
+/*                             OpenNative()                             */
+/*                                                                      */
+/* Open the in-driver decoder of the map, once. nullptr if the driver   */
+/* cannot decode the map.                                               */
+/************************************************************************/
+auto GRASSRasterBand::OpenNative() -> GRASSNativeRaster *
+{
+    if (bNativeChecked)
+        return poNative.get();
+    bNativeChecked = true;
+
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+    struct Cell_head sCellHead
+    {
+    };
+    {
+        auto oLock = GRASSSession::Acquire();
+        GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+        Rast_get_cellhd(osCellName.c_str(), osMapset.c_str(), &sCellHead);
+    }
+    poNative.reset(GRASSNativeRaster::Open(
+        poGDS->osGisdbase + "/" + poGDS->osLocation + "/" + osMapset,
+        osCellName, sCellHead, nGRSType));
+
+    return poNative.get();
+}
+
+/************************************************************************/
+/*                           PrepareReading()                           */
+/*                                                                      */
+/* Decide on first read how rows are decoded.                           */
+/************************************************************************/
+void GRASSRasterBand::PrepareReading()
+{
+    if (bReadingPrepared)
+        return;
+    bReadingPrepared = true;
+
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    SetRowCacheMap(oRowCacheKey,
+                   poGDS->osGisdbase + "/" + poGDS->osLocation + "/" +
+                       osMapset,
+                   osCellName, nGRSType);
+
+    // uncompressed maps may be memory mapped, see GetMappedData()
+    if (poGDS->bNativeDecoder || nCompressed == 0)
+    {
+        OpenNative();
+        if (!poNative && poGDS->bNativeDecoder && nGRSType == CELL_TYPE)
+            OpenReclass();
+        bNativeRows = (poNative || poReclassBase) && poGDS->bNativeDecoder;
+        if (!bNativeRows && poGDS->bNativeDecoder)
+            CPLDebug("GRASS", "Reading %s@%s through libgrass",
+                     osCellName.c_str(), osMapset.c_str());
+    }
+}
+
+/************************************************************************/
+/*                            OpenReclass()                             */
+/*                                                                      */
+/* Reclass maps have no data of their own: libgrass reads a row of the  */
+/* base map and looks its cells up in the reclass table. The table is   */
+/* loaded once here and the base map opened with the in-driver decoder. */
+/* Base rows are shared through the row cache under the key of the base */
+/* map, so the reclass maps of a base and the base itself decode them   */
+/* once.                                                                */
+/************************************************************************/
+
+void GRASSRasterBand::OpenReclass()
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+    std::array<char, GNAME_MAX> szBaseName{};
+    std::array<char, GMAPSET_MAX> szBaseMapset{};
+    struct Reclass sReclass
+    {
+    };
+    struct Cell_head sBaseCellHead
+    {
+    };
+
+    // libgrass applies the MASK of the mapset of the reclass map, the
+    // decoder only checks the mapset of the base map
+    VSIStatBufL sMaskStat;
+    const std::string osMask = poGDS->osGisdbase + "/" + poGDS->osLocation +
+                               "/" + osMapset + "/cell/MASK";
+    if (VSIStatL(osMask.c_str(), &sMaskStat) == 0)
+        return;
+
+    {
+        auto oLock = GRASSSession::Acquire();
+        GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+        if (Rast_is_reclass(osCellName.c_str(), osMapset.c_str(),
+                            szBaseName.data(), szBaseMapset.data()) <= 0 ||
+            Rast_get_reclass(osCellName.c_str(), osMapset.c_str(),
+                             &sReclass) <= 0)
+            return;
+        if (sReclass.type == RECLASS_TABLE && sReclass.num > 0)
+        {
+            anReclassTable.assign(sReclass.table,
+                                  sReclass.table + sReclass.num);
+            nReclassMin = sReclass.min;
+        }
+        Rast_free_reclass(&sReclass);
+        Rast_get_cellhd(szBaseName.data(), szBaseMapset.data(),
+                        &sBaseCellHead);
+    }
+    if (anReclassTable.empty())
+        return;
+
+    const std::string osBaseMapsetDir = poGDS->osGisdbase + "/" +
+                                        poGDS->osLocation + "/" +
+                                        szBaseMapset.data();
+    poReclassBase.reset(GRASSNativeRaster::Open(
+        osBaseMapsetDir, szBaseName.data(), sBaseCellHead, CELL_TYPE));
+    if (!poReclassBase)
+    {
+        anReclassTable.clear();
+        return;
+    }
+
+    CPLDebug("GRASS", "Reading reclass map %s@%s from %s@%s",
+             osCellName.c_str(), osMapset.c_str(), szBaseName.data(),
+             szBaseMapset.data());
+
+    SetRowCacheMap(oBaseRowCacheKey, osBaseMapsetDir, szBaseName.data(),
+                   CELL_TYPE);
+
+    // the reclass map has a header and no data file, its rows change
+    // with the header or the base map
+    VSIStatBufL sStat;
+    const std::string osHeader = poGDS->osGisdbase + "/" + poGDS->osLocation +
+                                 "/" + osMapset + "/cellhd/" + osCellName;
+    oRowCacheKey.nMTime =
+        VSIStatL(osHeader.c_str(), &sStat) == 0 && oBaseRowCacheKey.nMTime >= 0
+            ? std::max(static_cast<GIntBig>(sStat.st_mtime),
+                       oBaseRowCacheKey.nMTime)
+            : -1;
+    oRowCacheKey.nSize += oBaseRowCacheKey.nSize;
+}
+
+/************************************************************************/
+/*                           ReadNativeRow()                            */
+/*                                                                      */
+/* Read a row with the in-driver decoder, through the base map and the  */
+/* reclass table for reclass maps. Thread safe. Base rows missing from  */
+/* the row cache are added to it if bKeep.                              */
+/************************************************************************/
+
+auto GRASSRasterBand::ReadNativeRow(const struct Cell_head &sWindow, int nRow,
+                                    void *pBuffer, bool bKeep) -> bool
+{
+    if (!poReclassBase)
+        return poNative->ReadRow(sWindow, nRow, pBuffer);
+
+    const size_t nRowBytes = static_cast<size_t>(sWindow.cols) * sizeof(CELL);
+    const bool bUseCache = GRASSRowCache::IsEnabled();
+    GRASSRowCache::Key oKey;
+    if (bUseCache)
+    {
+        oKey = oBaseRowCacheKey;
+        SetRowCacheWindow(oKey, sWindow, nRow);
+    }
+    if (!bUseCache || !GRASSRowCache::Get(oKey, pBuffer, nRowBytes))
+    {
+        if (!poReclassBase->ReadRow(sWindow, nRow, pBuffer))
+            return false;
+        if (bUseCache && bKeep)
+            GRASSRowCache::Put(oKey, pBuffer, nRowBytes);
+    }
+
+    GRASSReclassRow(static_cast<CELL *>(pBuffer), sWindow.cols,
+                    anReclassTable.data(), nReclassMin,
+                    nReclassMin +
+                        static_cast<CELL>(anReclassTable.size() - 1));
+    return true;
+}
+
+/************************************************************************/
+/*                             ReadGRASSRow                             */
+/*                                                                      */
+/* Read a row of the window prepared by BeginRead() as CELL, FCELL or   */
+/* DCELL (according to the raster type) with GRASS null values. Rows    */
+/* are looked up in the shared row cache, and added to it if bKeep:     */
+/* scans reading each row once pass false to leave the cached rows of   */
+/* other reads in place.                                                */
+/************************************************************************/
+auto GRASSRasterBand::ReadGRASSRow(struct Cell_head *psWindow, int nRow,
+                                   void *pBuffer, bool bKeep) -> CPLErr
+{
+    const bool bUseCache = bReadingPrepared && GRASSRowCache::IsEnabled();
+    const size_t nRowBytes =
+        static_cast<size_t>(psWindow->cols) *
+        GDALGetDataTypeSizeBytes(GRASSRowDataType(nGRSType));
+    GRASSRowCache::Key oKey;
+    if (bUseCache)
+    {
+        oKey = oRowCacheKey;
+        SetRowCacheWindow(oKey, *psWindow, nRow);
+        if (GRASSRowCache::Get(oKey, pBuffer, nRowBytes))
+            return CE_None;
+    }
+
+    if (bNativeRows)
+    {
+        if (!ReadNativeRow(*psWindow, nRow, pBuffer, bKeep))
+            return CE_Failure;
+    }
+    else if (nGRSType == CELL_TYPE)
+        Rast_get_c_row(hCell, static_cast<CELL *>(pBuffer), nRow);
+    else if (nGRSType == FCELL_TYPE)
+        Rast_get_f_row(hCell, static_cast<FCELL *>(pBuffer), nRow);
+    else
+        Rast_get_d_row(hCell, static_cast<DCELL *>(pBuffer), nRow);
+
+    if (bUseCache && bKeep)
+        GRASSRowCache::Put(oKey, pBuffer, nRowBytes);
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                            GetMappedData()                           */
+/*                                                                      */
+/* Raw rows of the map if the file can be read without decoding: an     */
+/* uncompressed map without null cells, read in its own region, and     */
+/* stored with the size (and, for CELL maps, the nodata value) of the   */
+/* band data type. Values are big endian.                               */
+/************************************************************************/
+auto GRASSRasterBand::GetMappedData() -> const GByte *
+{
+    PrepareReading();
+    if (!poNative)
+        return nullptr;
+
+    const struct Cell_head &sMapCellHead = poNative->GetCellHead();
+    const struct Cell_head *psDsWindow =
+        &((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo);
+    if (!SameWindow(psDsWindow, &sMapCellHead))
+        return nullptr;
+
+    if (poNative->GetCellBytes() != GDALGetDataTypeSizeBytes(eDataType))
+        return nullptr;
+
+    if (nGRSType == CELL_TYPE)
+    {
+        // 4 byte cells are sign-magnitude, same as Int32 for positive values
+        if (eDataType == GDT_Int32 && !(bHaveMinMax && dfCellMin >= 0))
+            return nullptr;
+        // without null file zero cells are null
+        if (!poNative->HasNullFile() && dfNoData != 0.0)
+            return nullptr;
+    }
+
+    return poNative->GetMappedData();
+}
+
+/************************************************************************/
+/*                          GetVirtualMemAuto()                         */
+/************************************************************************/
+
+auto GRASSRasterBand::GetVirtualMemAuto(GDALRWFlag eRWFlag, int *pnPixelSpace,
+                                        GIntBig *pnLineSpace,
+                                        char **papszOptions) -> CPLVirtualMem *
+{
+    const int nDataTypeSize = GDALGetDataTypeSizeBytes(eDataType);
+
+    // The file can be mapped as is only if it is in the host byte order,
+    // otherwise the default implementation fills pages through IRasterIO
+#ifdef CPL_LSB
+    const bool bNativeOrder = nDataTypeSize == 1;
+#else
+    const bool bNativeOrder = true;
+#endif
+    if (eRWFlag == GF_Read && bNativeOrder && GetMappedData() != nullptr)
+    {
+        CPLVirtualMem *psVMem = poNative->MapData();
+        if (psVMem)
+        {
+            if (pnPixelSpace)
+                *pnPixelSpace = nDataTypeSize;
+            if (pnLineSpace)
+                *pnLineSpace =
+                    static_cast<GIntBig>(nRasterXSize) * nDataTypeSize;
+            return psVMem;
+        }
+    }
+
+    return GDALRasterBand::GetVirtualMemAuto(eRWFlag, pnPixelSpace,
+                                             pnLineSpace, papszOptions);
+}
+
+/************************************************************************/
+/*                            GetWorkerPool()                           */
+/*                                                                      */
+/* The worker processes, started on first use. Workers are forked with  */
+/* the GRASS state of this process, so it must be consistent and have   */
+/* no open rasters at that time.                                        */
+/************************************************************************/
+auto GRASSRasterBand::GetWorkerPool() -> GRASSWorkerPool *
+{
+    GRASSWorkerPool *poPool = nullptr;
+
+    if (GRASSWorkerPool::IsRunning())
+    {
+        poPool = GRASSWorkerPool::Get();
+    }
+    else
+    {
+        auto oLock = GRASSSession::Acquire();
+        auto oBands = oHandlePool;
+        for (auto poBand : oBands)
+            poBand->CloseRaster();
+        poPool = GRASSWorkerPool::Get();
+    }
+
+    return poPool && poPool->GetWorkerCount() > 1 ? poPool : nullptr;
+}
+
+/************************************************************************/
+/*                              UseWorkers()                            */
+/*                                                                      */
+/* Whether nRows rows of psWindow are read by the worker processes.     */
+/************************************************************************/
+auto GRASSRasterBand::UseWorkers(const struct Cell_head *psWindow, int nRows)
+    -> bool
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    return poGDS->bWorkerProcesses && !bNativeRows && nRows > 1 &&
+           GRASSWorkerPool::CanRead(nGRSType, psWindow->cols) &&
+           GetWorkerPool() != nullptr;
+}
+
+/************************************************************************/
+/*                          ReadRowsInWorkers()                         */
+/************************************************************************/
+auto GRASSRasterBand::ReadRowsInWorkers(
+    const struct Cell_head *psWindow, int nFirstRow, int nRows,
+    const GRASSWorkerPool::RowHandler &pfnHandler) -> CPLErr
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+    GRASSWorkerPool *poPool = GetWorkerPool();
+    if (poPool == nullptr)
+        return CE_Failure;
+
+    GRASSWorkerPool::Request oRequest;
+    oRequest.osGisdbase = poGDS->osGisdbase;
+    oRequest.osLocation = poGDS->osLocation;
+    oRequest.osMapset = osMapset;
+    oRequest.osName = osCellName;
+    oRequest.nMapType = nGRSType;
+    oRequest.sWindow = *psWindow;
+
+    return poPool->ReadRows(oRequest, nFirstRow, nRows, pfnHandler)
+               ? CE_None
+               : CE_Failure;
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/*                                                                      */
+/* A block is a strip of nBlockYSize consecutive rows (see BLOCK_YSIZE) */
 /************************************************************************/
 
 auto GRASSRasterBand::IReadBlock(int /*nBlockXOff*/, int nBlockYOff,
                                  void *pImage) -> CPLErr
 {
-    if (!this->valid)
-        return CE_Failure;
+    if (!this->valid)
+        return CE_Failure;
+
+    const int nDataTypeSize = GDALGetDataTypeSizeBytes(eDataType);
+    const int nFirstRow = nBlockYOff * nBlockYSize;
+    const int nRows = std::min(nBlockYSize, nRasterYSize - nFirstRow);
+
+    if (const GByte *pabyMapped = GetMappedData())
+    {
+        const size_t nBlockBytes =
+            static_cast<size_t>(nRows) * nBlockXSize * nDataTypeSize;
+        memcpy(pImage,
+               pabyMapped + static_cast<size_t>(nFirstRow) * nBlockXSize *
+                                nDataTypeSize,
+               nBlockBytes);
+#ifdef CPL_LSB
+        if (nDataTypeSize > 1)
+            GDALSwapWordsEx(pImage, nDataTypeSize,
+                            static_cast<size_t>(nRows) * nBlockXSize,
+                            nDataTypeSize);
+#endif
+        return CE_None;
+    }
+
+    struct Cell_head *psDsWindow =
+        &((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo);
+
+    // converts a row read as CELL, FCELL or DCELL into the block
+    auto CopyRow = [&](int row, void *pRowData)
+    {
+        void *pRow = static_cast<GByte *>(pImage) +
+                     static_cast<size_t>(row - nFirstRow) * nBlockXSize *
+                         nDataTypeSize;
+
+        if (pRowData != pRow)
+            GRASSCopyRow(pRowData, nGRSType, pRow, eDataType, nDataTypeSize,
+                         nBlockXSize, dfNoData);
+    };
+
+    // Byte and UInt16 bands are narrowed from CELL rows
+    const bool bNarrow = eDataType == GDT_Byte || eDataType == GDT_UInt16;
+    if (bNarrow)
+        abyRowScratch.resize(static_cast<size_t>(nBlockXSize) * sizeof(CELL));
+
+    auto GetRowData = [&](int iRow) -> void *
+    {
+        return bNarrow ? static_cast<void *>(abyRowScratch.data())
+                       : static_cast<GByte *>(pImage) +
+                             static_cast<size_t>(iRow) * nBlockXSize *
+                                 nDataTypeSize;
+    };
+
+    // a sequential scan has its next blocks decoded in advance
+    nSequentialBlocks =
+        nBlockYOff == nLastBlockYOff + 1 ? nSequentialBlocks + 1 : 0;
+    nLastBlockYOff = nBlockYOff;
+    if (nSequentialBlocks == 2 &&
+        !(poPrefetcher && poPrefetcher->Covers(nFirstRow + nRows)))
+        StartPrefetch(nFirstRow + nRows, nRasterYSize);
+
+    int iFirstRow = 0;
+    while (iFirstRow < nRows &&
+           TakePrefetchedRow(nFirstRow + iFirstRow, 0, nBlockXSize,
+                             GetRowData(iFirstRow)))
+    {
+        CopyRow(nFirstRow + iFirstRow, GetRowData(iFirstRow));
+        iFirstRow++;
+    }
+    if (iFirstRow == nRows)
+        return CE_None;
+
+    if (UseWorkers(psDsWindow, nRows - iFirstRow))
+        return ReadRowsInWorkers(psDsWindow, nFirstRow + iFirstRow,
+                                 nRows - iFirstRow, CopyRow);
+
+    // the GRASS libraries are not thread safe
+    GRASSSession::Lock oLock;
+    if (!bNativeRows)
+        oLock = GRASSSession::Acquire();
+
+    // Reset window because IRasterIO could be previously called.
+    if (BeginRead(psDsWindow) != CE_None)
+        return CE_Failure;
+
+    for (int iRow = iFirstRow; iRow < nRows; iRow++)
+    {
+        const int row = nFirstRow + iRow;
+        void *pRowData = GetRowData(iRow);
+
+        if (ReadGRASSRow(psDsWindow, row, pRowData) != CE_None)
+            return CE_Failure;
+
+        CopyRow(row, pRowData);
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/*                                                                      */
+/************************************************************************/
+
+auto GRASSRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff,
+                                int nXSize, int nYSize, void *pData,
+                                int nBufXSize, int nBufYSize,
+                                GDALDataType eBufType, GSpacing nPixelSpace,
+                                GSpacing nLineSpace,
+                                GDALRasterIOExtraArg *psExtraArg) -> CPLErr
+{
+    /* GRASS library does that, we have only calculate and reset the region in map units
+     * and if the region has changed, reopen the raster */
+
+    /* Calculate the region */
+    struct Cell_head sWindow
+    {
+    };
+    struct Cell_head *psDsWindow = nullptr;
+
+    if (eRWFlag != GF_Read)
+        return CE_Failure;
+    if (!this->valid)
+        return CE_Failure;
+    PrepareReading();
+
+    psDsWindow = &((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo);
+
+    /* Reset space if default (0) */
+    if (nPixelSpace == 0)
+        nPixelSpace = GDALGetDataTypeSizeBytes(eBufType);
+
+    if (nLineSpace == 0)
+        nLineSpace = nBufXSize * nPixelSpace;
+
+    /* Read downsampled requests from the overviews if there are any */
+    if ((nBufXSize < nXSize || nBufYSize < nYSize) && GetOverviewCount() > 0)
+    {
+        if (OverviewRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize, pData,
+                             nBufXSize, nBufYSize, eBufType, nPixelSpace,
+                             nLineSpace, psExtraArg) == CE_None)
+            return CE_None;
+    }
+
+    /* Copy from the memory mapped file if possible */
+    const GByte *pabyMapped = nullptr;
+    if (nXSize == nBufXSize && nYSize == nBufYSize &&
+        (pabyMapped = GetMappedData()) != nullptr)
+    {
+        const int nDataTypeSize = GDALGetDataTypeSizeBytes(eDataType);
+        const size_t nFileLineSize =
+            static_cast<size_t>(nRasterXSize) * nDataTypeSize;
+        const bool bSameType = eBufType == eDataType;
+        std::vector<GByte> &abyRow = abyRowScratch;
+
+        if (!bSameType)
+            abyRow.resize(static_cast<size_t>(nBufXSize) * nDataTypeSize);
+
+        for (int row = 0; row < nBufYSize; row++)
+        {
+            const GByte *pabySrc = pabyMapped +
+                                   static_cast<size_t>(nYOff + row) *
+                                       nFileLineSize +
+                                   static_cast<size_t>(nXOff) * nDataTypeSize;
+            GByte *pabyDst = static_cast<GByte *>(pData) + row * nLineSpace;
+
+            if (bSameType)
+            {
+                GDALCopyWords(pabySrc, eDataType, nDataTypeSize, pabyDst,
+                              eBufType, (int)nPixelSpace, nBufXSize);
+#ifdef CPL_LSB
+                if (nDataTypeSize > 1)
+                    GDALSwapWords(pabyDst, nDataTypeSize, nBufXSize,
+                                  (int)nPixelSpace);
+#endif
+            }
+            else
+            {
+                memcpy(abyRow.data(), pabySrc,
+                       static_cast<size_t>(nBufXSize) * nDataTypeSize);
+#ifdef CPL_LSB
+                if (nDataTypeSize > 1)
+                    GDALSwapWords(abyRow.data(), nDataTypeSize, nBufXSize,
+                                  nDataTypeSize);
+#endif
+                GDALCopyWords(abyRow.data(), eDataType, nDataTypeSize,
+                              pabyDst, eBufType, (int)nPixelSpace, nBufXSize);
+            }
+
+            if (!RasterIOProgress(psExtraArg, (row + 1.0) / nBufYSize))
+                return CE_Failure;
+        }
+
+        CountDirectIO(nBufXSize, nBufYSize, eBufType);
+        return CE_None;
+    }
+
+    /* Small requests are served from (and kept in) the block cache */
+    if (!UseDirectIO(nYOff, nXSize, nYSize, nBufXSize, nBufYSize))
+        return GDALRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                         pData, nBufXSize, nBufYSize, eBufType,
+                                         nPixelSpace, nLineSpace, psExtraArg);
+    CountDirectIO(nBufXSize, nBufYSize, eBufType);
+
+    /* Other resamplings than nearest neighbour are done here */
+    if ((nBufXSize != nXSize || nBufYSize != nYSize) &&
+        psExtraArg != nullptr &&
+        GRASSResampler::Supports(psExtraArg->eResampleAlg))
+    {
+        return ResampledRasterIO(nXOff, nYOff, nXSize, nYSize, pData,
+                                 nBufXSize, nBufYSize, eBufType, nPixelSpace,
+                                 nLineSpace, psExtraArg);
+    }
+
+    GetReadWindow(psDsWindow, nXOff, nYOff, nXSize, nYSize, nBufXSize,
+                  nBufYSize, &sWindow);
+
+    /* Read Data */
+    const GDALDataType eRowType = GRASSRowDataType(nGRSType);
+    const int nRowTypeSize = GDALGetDataTypeSizeBytes(eRowType);
+    bool direct = false;
+
+    if (nGRSType == CELL_TYPE)
+        direct = nativeNulls && eBufType == GDT_Int32 && sizeof(CELL) == 4 &&
+                 nPixelSpace == sizeof(CELL);
+    else
+        direct = eBufType == eRowType && nPixelSpace == nRowTypeSize;
+
+    if (!direct)
+        abyRowScratch.resize(static_cast<size_t>(nBufXSize) * nRowTypeSize);
+
+    // converts a row read as CELL, FCELL or DCELL into the buffer
+    auto CopyRow = [&](int row, void *pRowData)
+    {
+        char *pnt = static_cast<char *>(pData) + row * nLineSpace;
+
+        if (direct)
+        {
+            if (pRowData != pnt)
+                memcpy(pnt, pRowData,
+                       static_cast<size_t>(nBufXSize) * nRowTypeSize);
+            return;
+        }
+
+        GRASSCopyRow(pRowData, nGRSType, pnt, eBufType, (int)nPixelSpace,
+                     nBufXSize, dfNoData);
+    };
+
+    /* Rows decoded in advance, see AdviseRead() */
+    int nFirstBufRow = 0;
+    if (poPrefetcher && nBufXSize == nXSize && nBufYSize == nYSize)
+    {
+        for (; nFirstBufRow < nBufYSize; nFirstBufRow++)
+        {
+            void *pRowData =
+                direct ? static_cast<char *>(pData) + nFirstBufRow * nLineSpace
+                       : static_cast<void *>(abyRowScratch.data());
+
+            if (!TakePrefetchedRow(nYOff + nFirstBufRow, nXOff, nXSize,
+                                   pRowData))
+                break;
+
+            CopyRow(nFirstBufRow, pRowData);
+
+            if (!RasterIOProgress(psExtraArg,
+                                  (nFirstBufRow + 1.0) / nBufYSize))
+                return CE_Failure;
+        }
+        if (nFirstBufRow == nBufYSize)
+            return CE_None;
+    }
+
+    if (UseWorkers(&sWindow, nBufYSize))
+    {
+        // rows come back by ranges, only the completion is reported
+        if (ReadRowsInWorkers(&sWindow, 0, nBufYSize, CopyRow) != CE_None)
+            return CE_Failure;
+        return RasterIOProgress(psExtraArg, 1.0) ? CE_None : CE_Failure;
+    }
+
+    // the GRASS libraries are not thread safe
+    GRASSSession::Lock oLock;
+    if (!bNativeRows)
+        oLock = GRASSSession::Acquire();
+
+    if (BeginRead(&sWindow) != CE_None)
+        return CE_Failure;
+
+    for (int row = nFirstBufRow; row < nBufYSize; row++)
+    {
+        void *pRowData = direct ? static_cast<char *>(pData) + row * nLineSpace
+                                : static_cast<void *>(abyRowScratch.data());
+
+        if (ReadGRASSRow(&sWindow, row, pRowData, false) != CE_None)
+            return CE_Failure;
+
+        CopyRow(row, pRowData);
+
+        if (!RasterIOProgress(psExtraArg, (row + 1.0) / nBufYSize))
+            return CE_Failure;
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                            UseDirectIO()                             */
+/*                                                                      */
+/* Whether a request is read row by row straight into the buffer. Full  */
+/* resolution requests smaller than GRASS_DIRECT_IO_KB kilobytes go     */
+/* through the GDAL block cache, so that repeated small reads are       */
+/* cached while large scans do not evict the blocks of other datasets.  */
+/* Resampled requests and rows being prefetched are always read         */
+/* directly.                                                            */
+/************************************************************************/
+
+auto GRASSRasterBand::UseDirectIO(int nYOff, int nXSize, int nYSize,
+                                  int nBufXSize, int nBufYSize) -> bool
+{
+    if (nBufXSize != nXSize || nBufYSize != nYSize)
+        return true;
+    if (poPrefetcher && poPrefetcher->Covers(nYOff))
+        return true;
+
+    const GIntBig nThreshold =
+        static_cast<GIntBig>(
+            atoi(CPLGetConfigOption("GRASS_DIRECT_IO_KB", "64"))) *
+        1024;
+    return static_cast<GIntBig>(nXSize) * nYSize *
+               GDALGetDataTypeSizeBytes(eDataType) >=
+           nThreshold;
+}
+
+/************************************************************************/
+/*                           CountDirectIO()                            */
+/************************************************************************/
+
+void GRASSRasterBand::CountDirectIO(int nBufXSize, int nBufYSize,
+                                    GDALDataType eBufType)
+{
+    nDirectIORequests++;
+    nDirectIOBytes += static_cast<GUIntBig>(nBufXSize) * nBufYSize *
+                      GDALGetDataTypeSizeBytes(eBufType);
+}
+
+/************************************************************************/
+/*                         ResampledRasterIO()                          */
+/*                                                                      */
+/* Read the source window at full resolution, one row at a time, and    */
+/* resample it with GRASSResampler. Null cells are left out of the      */
+/* kernels instead of being resampled as nodata values.                 */
+/************************************************************************/
+
+auto GRASSRasterBand::ResampledRasterIO(int nXOff, int nYOff, int nXSize,
+                                        int nYSize, void *pData, int nBufXSize,
+                                        int nBufYSize, GDALDataType eBufType,
+                                        GSpacing nPixelSpace,
+                                        GSpacing nLineSpace,
+                                        GDALRasterIOExtraArg *psExtraArg)
+    -> CPLErr
+{
+    double dfXOff = nXOff;
+    double dfYOff = nYOff;
+    double dfXSize = nXSize;
+    double dfYSize = nYSize;
+    if (psExtraArg->bFloatingPointWindowValidity)
+    {
+        dfXOff = psExtraArg->dfXOff;
+        dfYOff = psExtraArg->dfYOff;
+        dfXSize = psExtraArg->dfXSize;
+        dfYSize = psExtraArg->dfYSize;
+    }
+
+    GRASSResampler oResampler(psExtraArg->eResampleAlg, dfXOff, dfYOff,
+                              dfXSize, dfYSize, nRasterXSize, nRasterYSize,
+                              nBufXSize, nBufYSize);
+    const int nSrcXSize = oResampler.GetSrcXSize();
+    const int nSrcYSize = oResampler.GetSrcYSize();
+
+    /* Source window at the resolution of the map */
+    struct Cell_head sWindow
+    {
+    };
+    GetReadWindow(&((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo),
+                  oResampler.GetSrcXOff(), oResampler.GetSrcYOff(), nSrcXSize,
+                  nSrcYSize, nSrcXSize, nSrcYSize, &sWindow);
+
+    const GDALDataType eRowType = GRASSRowDataType(nGRSType);
+    std::vector<GByte> abyRow(static_cast<size_t>(nSrcXSize) *
+                              GDALGetDataTypeSizeBytes(eRowType));
+    std::vector<double> adfRow(nSrcXSize);
+    std::vector<double> adfOut(nBufXSize);
+    int nOutRow = 0;
+
+    // the GRASS libraries are not thread safe
+    GRASSSession::Lock oLock;
+    if (!bNativeRows)
+        oLock = GRASSSession::Acquire();
+
+    if (BeginRead(&sWindow) != CE_None)
+        return CE_Failure;
+
+    for (int row = 0; row < nSrcYSize && nOutRow < nBufYSize; row++)
+    {
+        if (ReadGRASSRow(&sWindow, row, abyRow.data(), false) != CE_None)
+            return CE_Failure;
+
+        /* Nulls as NaN */
+        if (nGRSType == CELL_TYPE)
+        {
+            const CELL *panRow = reinterpret_cast<const CELL *>(abyRow.data());
+            for (int col = 0; col < nSrcXSize; col++)
+                adfRow[col] = Rast_is_c_null_value(&panRow[col])
+                                  ? std::numeric_limits<double>::quiet_NaN()
+                                  : panRow[col];
+        }
+        else if (nGRSType == FCELL_TYPE)
+        {
+            const FCELL *pafRow =
+                reinterpret_cast<const FCELL *>(abyRow.data());
+            for (int col = 0; col < nSrcXSize; col++)
+                adfRow[col] = Rast_is_f_null_value(&pafRow[col])
+                                  ? std::numeric_limits<double>::quiet_NaN()
+                                  : pafRow[col];
+        }
+        else
+        {
+            const DCELL *padfRow =
+                reinterpret_cast<const DCELL *>(abyRow.data());
+            for (int col = 0; col < nSrcXSize; col++)
+                adfRow[col] = Rast_is_d_null_value(&padfRow[col])
+                                  ? std::numeric_limits<double>::quiet_NaN()
+                                  : padfRow[col];
+        }
+
+        oResampler.PushRow(adfRow.data());
+
+        while (oResampler.NextRow(adfOut.data()))
+        {
+            if (nGRSType == CELL_TYPE)
+            {
+                for (auto &dfValue : adfOut)
+                {
+                    if (std::isnan(dfValue))
+                        dfValue = dfNoData;
+                }
+            }
+
+            GDALCopyWords(adfOut.data(), GDT_Float64, sizeof(double),
+                          static_cast<GByte *>(pData) + nOutRow * nLineSpace,
+                          eBufType, static_cast<int>(nPixelSpace), nBufXSize);
+            nOutRow++;
+
+            if (!RasterIOProgress(psExtraArg,
+                                  static_cast<double>(nOutRow) / nBufYSize))
+                return CE_Failure;
+        }
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                       GetColorInterpretation()                       */
+/************************************************************************/
+
+auto GRASSRasterBand::GetColorInterpretation() -> GDALColorInterp
+{
+    if (LoadColors())
+        return GCI_PaletteIndex;
+    else
+        return GCI_GrayIndex;
+}
+
+/************************************************************************/
+/*                             LoadColors()                             */
+/*                                                                      */
+/* Read the color rules of the map, once. False if the map has none.    */
+/************************************************************************/
+
+auto GRASSRasterBand::LoadColors() -> bool
+{
+    if (bColorsLoaded)
+        return bHaveColors;
+    bColorsLoaded = true;
+
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+    auto oLock = GRASSSession::Acquire();
+    GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+
+    // 0 when default colors were made up for the map
+    bHaveColors = Rast_read_colors(osCellName.c_str(), osMapset.c_str(),
+                                   &sGrassColors) == 1;
+    return bHaveColors;
+}
+
+/************************************************************************/
+/*                           LoadCategories()                           */
+/*                                                                      */
+/* Read the category labels of a CELL map, once, into the raster        */
+/* attribute table, and into the category names if all labelled values */
+/* are between 0 and MAX_CATEGORY_NAMES - 1.                            */
+/************************************************************************/
+
+void GRASSRasterBand::LoadCategories()
+{
+    static constexpr CELL MAX_CATEGORY_NAMES = 65536;
+
+    if (bCategoriesLoaded)
+        return;
+    bCategoriesLoaded = true;
+
+    if (nGRSType != CELL_TYPE)
+        return;
+
+    // libgrass warns about maps without labels
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+    const std::string osCatsFile = poGDS->osGisdbase + "/" +
+                                   poGDS->osLocation + "/" + osMapset +
+                                   "/cats/" + osCellName;
+    VSIStatBufL sStat;
+    if (VSIStatL(osCatsFile.c_str(), &sStat) != 0)
+        return;
+
+    auto oLock = GRASSSession::Acquire();
+    GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+
+    struct Categories sCats
+    {
+    };
+    if (Rast_read_cats(osCellName.c_str(), osMapset.c_str(), &sCats) != 0)
+        return;
+
+    const int nCats = Rast_quant_nrules(&sCats.q);
+    bool bHaveRanges = false;
+    bool bNamesFit = true;
+    CELL nMaxValue = 0;
+    for (int iCat = 0; iCat < nCats; iCat++)
+    {
+        CELL nMin = 0;
+        CELL nMax = 0;
+        Rast_get_ith_c_cat(&sCats, iCat, &nMin, &nMax);
+        bHaveRanges = bHaveRanges || nMin != nMax;
+        bNamesFit = bNamesFit && nMin >= 0 && nMax < MAX_CATEGORY_NAMES;
+        nMaxValue = std::max(nMaxValue, nMax);
+    }
+
+    if (nCats > 0)
+    {
+        poRAT.reset(new GRASSCategoryTable());
+        poRAT->SetTableType(GRTT_THEMATIC);
+        if (bHaveRanges)
+        {
+            poRAT->CreateColumn("Min", GFT_Integer, GFU_Min);
+            poRAT->CreateColumn("Max", GFT_Integer, GFU_Max);
+        }
+        else
+        {
+            poRAT->CreateColumn("Value", GFT_Integer, GFU_MinMax);
+        }
+        poRAT->CreateColumn("Label", GFT_String, GFU_Name);
+        poRAT->SetRowCount(nCats);
+    }
+
+    std::vector<std::string> aosNames;
+    if (nCats > 0 && bNamesFit)
+        aosNames.resize(static_cast<size_t>(nMaxValue) + 1);
+
+    const int iLabelField = bHaveRanges ? 2 : 1;
+    for (int iCat = 0; iCat < nCats; iCat++)
+    {
+        CELL nMin = 0;
+        CELL nMax = 0;
+        const char *pszLabel = Rast_get_ith_c_cat(&sCats, iCat, &nMin, &nMax);
+        if (pszLabel == nullptr)
+            pszLabel = "";
+
+        poRAT->SetValue(iCat, 0, static_cast<int>(nMin));
+        if (bHaveRanges)
+            poRAT->SetValue(iCat, 1, static_cast<int>(nMax));
+        poRAT->SetValue(iCat, iLabelField, pszLabel);
+
+        for (CELL nValue = nMin; !aosNames.empty() && nValue <= nMax; nValue++)
+            aosNames[nValue] = pszLabel;
+    }
+
+    if (poRAT)
+        poRAT->BuildIndex();
+
+    for (const std::string &osName : aosNames)
+        aosCategoryNames.AddString(osName.c_str());
+
+    Rast_free_cats(&sCats);
+}
+
+/************************************************************************/
+/*                           GetDefaultRAT()                            */
+/************************************************************************/
+
+auto GRASSRasterBand::GetDefaultRAT() -> GDALRasterAttributeTable *
+{
+    LoadCategories();
+    return poRAT.get();
+}
+
+/************************************************************************/
+/*                          GetCategoryNames()                          */
+/************************************************************************/
+
+auto GRASSRasterBand::GetCategoryNames() -> char **
+{
+    LoadCategories();
+    return aosCategoryNames.size() > 0 ? aosCategoryNames.List() : nullptr;
+}
+
+/************************************************************************/
+/*                     GRASSCategoryTable::BuildIndex()                 */
+/*                                                                      */
+/* Index the rows of the table as loaded, the Value column or the Min   */
+/* and Max columns.                                                     */
+/************************************************************************/
+
+void GRASSCategoryTable::BuildIndex()
+{
+    int iMinField = GetColOfUsage(GFU_MinMax);
+    int iMaxField = iMinField;
+    if (iMinField < 0)
+    {
+        iMinField = GetColOfUsage(GFU_Min);
+        iMaxField = GetColOfUsage(GFU_Max);
+    }
+
+    oRowOfValue.clear();
+    bHaveRanges = false;
+    for (int iRow = 0; iRow < GetRowCount(); iRow++)
+    {
+        const CELL nMin = GetValueAsInt(iRow, iMinField);
+        const CELL nMax = GetValueAsInt(iRow, iMaxField);
+        // the first row of a value wins, as in the default lookup
+        if (nMin == nMax)
+            oRowOfValue.emplace(nMin, iRow);
+        else
+            bHaveRanges = true;
+    }
+    bIndexed = true;
+}
+
+/************************************************************************/
+/*                     GRASSCategoryTable::DropIndex()                  */
+/************************************************************************/
+
+void GRASSCategoryTable::DropIndex()
+{
+    if (!bIndexed)
+        return;
+    std::unordered_map<CELL, int>().swap(oRowOfValue);
+    bIndexed = false;
+}
+
+/************************************************************************/
+/*                     GRASSCategoryTable::SetValue()                   */
+/************************************************************************/
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 11, 0)
+auto GRASSCategoryTable::SetValue(int iRow, int iField, const char *pszValue)
+    -> CPLErr
+{
+    DropIndex();
+    return GDALDefaultRasterAttributeTable::SetValue(iRow, iField, pszValue);
+}
+
+auto GRASSCategoryTable::SetValue(int iRow, int iField, int nValue) -> CPLErr
+{
+    DropIndex();
+    return GDALDefaultRasterAttributeTable::SetValue(iRow, iField, nValue);
+}
+
+auto GRASSCategoryTable::SetValue(int iRow, int iField, double dfValue)
+    -> CPLErr
+{
+    DropIndex();
+    return GDALDefaultRasterAttributeTable::SetValue(iRow, iField, dfValue);
+}
+#else
+void GRASSCategoryTable::SetValue(int iRow, int iField, const char *pszValue)
+{
+    DropIndex();
+    GDALDefaultRasterAttributeTable::SetValue(iRow, iField, pszValue);
+}
+
+void GRASSCategoryTable::SetValue(int iRow, int iField, int nValue)
+{
+    DropIndex();
+    GDALDefaultRasterAttributeTable::SetValue(iRow, iField, nValue);
+}
+
+void GRASSCategoryTable::SetValue(int iRow, int iField, double dfValue)
+{
+    DropIndex();
+    GDALDefaultRasterAttributeTable::SetValue(iRow, iField, dfValue);
+}
+#endif
+
+/************************************************************************/
+/*                    GRASSCategoryTable::SetRowCount()                 */
+/************************************************************************/
+
+void GRASSCategoryTable::SetRowCount(int nCount)
+{
+    DropIndex();
+    GDALDefaultRasterAttributeTable::SetRowCount(nCount);
+}
+
+/************************************************************************/
+/*                  GRASSCategoryTable::SetLinearBinning()              */
+/************************************************************************/
+
+auto GRASSCategoryTable::SetLinearBinning(double dfRow0Min, double dfBinSize)
+    -> CPLErr
+{
+    DropIndex();
+    return GDALDefaultRasterAttributeTable::SetLinearBinning(dfRow0Min,
+                                                             dfBinSize);
+}
+
+/************************************************************************/
+/*                   GRASSCategoryTable::GetRowOfValue()                */
+/*                                                                      */
+/* Single values are looked up in the index, ranges by the default      */
+/* scan of the Min and Max columns.                                     */
+/************************************************************************/
+
+auto GRASSCategoryTable::GetRowOfValue(double dfValue) const -> int
+{
+    if (!bIndexed)
+        return GDALDefaultRasterAttributeTable::GetRowOfValue(dfValue);
+
+    if (dfValue >= std::numeric_limits<CELL>::min() &&
+        dfValue <= std::numeric_limits<CELL>::max() &&
+        dfValue == std::floor(dfValue))
+    {
+        const auto oIter = oRowOfValue.find(static_cast<CELL>(dfValue));
+        if (oIter != oRowOfValue.end())
+            return oIter->second;
+    }
+
+    return bHaveRanges ? GDALDefaultRasterAttributeTable::GetRowOfValue(dfValue)
+                       : -1;
+}
+
+/************************************************************************/
+/*                           GetColorTable()                            */
+/*                                                                      */
+/* Built on first use from a single lookup of the colors of the values  */
+/* up to the maximum of the map (at most GRASS_MAX_COLORS).             */
+/************************************************************************/
+
+auto GRASSRasterBand::GetColorTable() -> GDALColorTable *
+{
+    if (poCT || !LoadColors())
+        return poCT.get();
+
+    int maxcolor = 0;
+    CELL min = 0, max = 0;
+
+    auto oLock = GRASSSession::Acquire();
+    Rast_get_c_color_range(&min, &max, &sGrassColors);
+
+    if (bHaveMinMax)
+    {
+        if (max < dfCellMax)
+        {
+            maxcolor = max;
+        }
+        else
+        {
+            maxcolor = (int)ceil(dfCellMax);
+        }
+        if (maxcolor > GRASS_MAX_COLORS)
+        {
+            maxcolor = GRASS_MAX_COLORS;
+            CPLDebug("GRASS", "Too many values, color table cut to %d entries.",
+                     maxcolor);
+        }
+    }
+    else
+    {
+        if (max < GRASS_MAX_COLORS)
+        {
+            maxcolor = max;
+        }
+        else
+        {
+            maxcolor = GRASS_MAX_COLORS;
+            CPLDebug("GRASS", "Too many values, color table set to %d entries.",
+                     maxcolor);
+        }
+    }
+
+    poCT.reset(new GDALColorTable());
+    // all the values with a color are negative
+    if (maxcolor < 0)
+        return poCT.get();
+
+    const int nColors = maxcolor + 1;
+    std::vector<CELL> anCells(nColors);
+    std::vector<unsigned char> abyRed(nColors), abyGreen(nColors),
+        abyBlue(nColors), abySet(nColors);
+    for (int iColor = 0; iColor < nColors; iColor++)
+        anCells[iColor] = iColor;
+
+    Rast_lookup_c_colors(anCells.data(), abyRed.data(), abyGreen.data(),
+                         abyBlue.data(), abySet.data(), nColors,
+                         &sGrassColors);
+
+    for (int iColor = 0; iColor < nColors; iColor++)
+    {
+        GDALColorEntry sColor;
+
+        if (abySet[iColor])
+        {
+            sColor.c1 = abyRed[iColor];
+            sColor.c2 = abyGreen[iColor];
+            sColor.c3 = abyBlue[iColor];
+            sColor.c4 = 255;
+        }
+        else
+        {
+            sColor.c1 = 0;
+            sColor.c2 = 0;
+            sColor.c3 = 0;
+            sColor.c4 = 0;
+        }
+
+        poCT->SetColorEntry(iColor, &sColor);
+    }
+
+    return poCT.get();
+}
+
+/************************************************************************/
+/*                           SetColorRules()                            */
+/*                                                                      */
+/* Metadata entries of the color rules, set on first access to the      */
+/* default metadata domain.                                             */
+/************************************************************************/
+
+void GRASSRasterBand::SetColorRules()
+{
+    if (bColorRulesSet)
+        return;
+    bColorRulesSet = true;
+
+    if (!LoadColors())
+    {
+        this->SetMetadataItem("COLOR_TABLE_RULES_COUNT", "0");
+        return;
+    }
+
+    std::array<char, BUFF_SIZE> value{};
+    std::array<char, BUFF_SIZE> key{};
+
+    auto oLock = GRASSSession::Acquire();
+    int rcount = Rast_colors_count(&sGrassColors);
+
+    (void)std::snprintf(value.data(), BUFF_SIZE, "%d", rcount);
+    this->SetMetadataItem("COLOR_TABLE_RULES_COUNT", value.data());
+
+    /* Add the rules in reverse order */
+    for (int i = rcount - 1; i >= 0; i--)
+    {
+        DCELL val1 = NAN, val2 = NAN;
+        unsigned char r1 = 0, g1 = 0, b1 = 0, r2 = 0, g2 = 0, b2 = 0;
+
+        Rast_get_fp_color_rule(&val1, &r1, &g1, &b1, &val2, &r2, &g2, &b2,
+                               &sGrassColors, i);
+
+        (void)std::snprintf(key.data(), key.size(), "COLOR_TABLE_RULE_RGB_%d",
+                            rcount - i - 1);
+        (void)std::snprintf(value.data(), value.size(),
+                            "%e %e %d %d %d %d %d %d", val1, val2, r1, g1, b1,
+                            r2, g2, b2);
+        this->SetMetadataItem(key.data(), value.data());
+    }
+}
+
+/************************************************************************/
+/*                             GetMinimum()                             */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMinimum(int *pbSuccess) -> double
+{
+    if (pbSuccess)
+        *pbSuccess = bHaveMinMax;
+
+    if (bHaveMinMax)
+        return dfCellMin;
+
+    else if (eDataType == GDT_Float32 || eDataType == GDT_Float64)
+        return -4294967295.0;
+    else
+        return 0;
+}
+
+/************************************************************************/
+/*                             GetMaximum()                             */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMaximum(int *pbSuccess) -> double
+{
+    if (pbSuccess)
+        *pbSuccess = bHaveMinMax;
+
+    if (bHaveMinMax)
+        return dfCellMax;
+
+    else if (eDataType == GDT_Float32 || eDataType == GDT_Float64 ||
+             eDataType == GDT_UInt32)
+        return 4294967295.0;
+    else if (eDataType == GDT_UInt16)
+        return 65535;
+    else
+        return 255;
+}
+
+/************************************************************************/
+/*                             GetMiscDir()                             */
+/*                                                                      */
+/* Directory of the support files of the map, cell_misc/<name>.         */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMiscDir() -> std::string
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    return poGDS->osGisdbase + "/" + poGDS->osLocation + "/" + osMapset +
+           "/cell_misc/" + osCellName;
+}
+
+/************************************************************************/
+/*                            GetMapMTime()                             */
+/*                                                                      */
+/* See GetMapFilesMTime().                                              */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMapMTime() -> GIntBig
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    return GetMapFilesMTime(poGDS->osGisdbase + "/" + poGDS->osLocation +
+                                "/" + osMapset,
+                            osCellName, nGRSType);
+}
+
+/************************************************************************/
+/*                            GetMapStamp()                             */
+/*                                                                      */
+/* See GetMapFilesStamp().                                              */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMapStamp() -> std::string
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    return GetMapFilesStamp(poGDS->osGisdbase + "/" + poGDS->osLocation +
+                                "/" + osMapset,
+                            osCellName, nGRSType);
+}
+
+/************************************************************************/
+/*                            HasMapRange()                             */
+/*                                                                      */
+/* Whether the range file gives the exact minimum and maximum of the    */
+/* band: it is read in the region of the map which has non null cells. */
+/************************************************************************/
+
+auto GRASSRasterBand::HasMapRange() -> bool
+{
+    return bMapRegion && bHaveMinMax && !std::isnan(dfCellMin) &&
+           !std::isnan(dfCellMax);
+}
+
+/************************************************************************/
+/*                        ComputeRasterMinMax()                         */
+/************************************************************************/
+
+auto GRASSRasterBand::ComputeRasterMinMax(int bApproxOK, double *adfMinMax)
+    -> CPLErr
+{
+    if (HasMapRange())
+    {
+        adfMinMax[0] = dfCellMin;
+        adfMinMax[1] = dfCellMax;
+        return CE_None;
+    }
+
+    return GDALRasterBand::ComputeRasterMinMax(bApproxOK, adfMinMax);
+}
+
+/************************************************************************/
+/*                         ReadMapStatistics()                          */
+/*                                                                      */
+/* Minimum, maximum, mean and standard deviation from the range file    */
+/* and the sums kept in cell_misc/<name>/stats (r.support -s).          */
+/************************************************************************/
+
+auto GRASSRasterBand::ReadMapStatistics(double *padfStats) -> bool
+{
+    VSIStatBufL sStat;
+    if (!HasMapRange() || VSIStatL((GetMiscDir() + "/stats").c_str(), &sStat) != 0)
+        return false;
+
+    struct R_stats sStats
+    {
+    };
+    {
+        auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+        auto oLock = GRASSSession::Acquire();
+        GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+        if (Rast_read_rstats(osCellName.c_str(), osMapset.c_str(),
+                             &sStats) != 1)
+            return false;
+    }
+    if (sStats.count <= 0)
+        return false;
+
+    const double dfCount = static_cast<double>(sStats.count);
+    const double dfMean = sStats.sum / dfCount;
+    padfStats[0] = dfCellMin;
+    padfStats[1] = dfCellMax;
+    padfStats[2] = dfMean;
+    padfStats[3] =
+        std::sqrt(std::max(sStats.sumsq / dfCount - dfMean * dfMean, 0.0));
+    return true;
+}
+
+/************************************************************************/
+/*                         ReadStatisticsFile()                         */
+/*                                                                      */
+/* Statistics computed by a previous scan of the map, kept in           */
+/* cell_misc/<name>/gdal_statistics with the stamp of the map files     */
+/* they were computed from, and used while it is unchanged.             */
+/************************************************************************/
+
+auto GRASSRasterBand::ReadStatisticsFile(double *padfStats) -> bool
+{
+    if (!bMapRegion)
+        return false;
+
+    const std::string osFile = GetMiscDir() + "/gdal_statistics";
+    VSIStatBufL sStat;
+    if (VSIStatL(osFile.c_str(), &sStat) != 0)
+        return false;
+
+    char **papszStats = CSLLoad(osFile.c_str());
+    const char *pszStamp = CSLFetchNameValue(papszStats, "MAP_FILES");
+    if (pszStamp == nullptr || GetMapStamp() != pszStamp)
+    {
+        CSLDestroy(papszStats);
+        return false;
+    }
+
+    const char *const apszKeys[] = {"STATISTICS_MINIMUM", "STATISTICS_MAXIMUM",
+                                    "STATISTICS_MEAN", "STATISTICS_STDDEV"};
+    bool bComplete = true;
+    for (int i = 0; i < 4; i++)
+    {
+        const char *pszValue = CSLFetchNameValue(papszStats, apszKeys[i]);
+        bComplete = bComplete && pszValue != nullptr;
+        padfStats[i] = pszValue ? CPLAtof(pszValue) : 0.0;
+    }
+    CSLDestroy(papszStats);
+
+    return bComplete;
+}
+
+/************************************************************************/
+/*                        WriteStatisticsFile()                         */
+/*                                                                      */
+/* Keep statistics computed by a scan for the next readers, if the      */
+/* mapset is writable.                                                  */
+/************************************************************************/
+
+void GRASSRasterBand::WriteStatisticsFile(const double *padfStats)
+{
+    if (!bMapRegion)
+        return;
+
+    const std::string osFile = GetMiscDir() + "/gdal_statistics";
+    char **papszStats = nullptr;
+    papszStats =
+        CSLSetNameValue(papszStats, "MAP_FILES", GetMapStamp().c_str());
+    papszStats = CSLSetNameValue(papszStats, "STATISTICS_MINIMUM",
+                                 CPLSPrintf("%.17g", padfStats[0]));
+    papszStats = CSLSetNameValue(papszStats, "STATISTICS_MAXIMUM",
+                                 CPLSPrintf("%.17g", padfStats[1]));
+    papszStats = CSLSetNameValue(papszStats, "STATISTICS_MEAN",
+                                 CPLSPrintf("%.17g", padfStats[2]));
+    papszStats = CSLSetNameValue(papszStats, "STATISTICS_STDDEV",
+                                 CPLSPrintf("%.17g", padfStats[3]));
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    VSIMkdirRecursive(GetMiscDir().c_str(), 0755);
+    if (!CSLSave(papszStats, osFile.c_str()))
+        CPLDebug("GRASS", "Cannot write statistics to %s", osFile.c_str());
+    CPLPopErrorHandler();
+
+    CSLDestroy(papszStats);
+}
+
+/************************************************************************/
+/*                           GetStatistics()                            */
+/*                                                                      */
+/* From the support files of the map when it has them, so that no scan  */
+/* of the map is needed. Statistics computed otherwise by an exact scan */
+/* are saved for the next time.                                         */
+/************************************************************************/
+
+auto GRASSRasterBand::GetStatistics(int bApproxOK, int bForce, double *pdfMin,
+                                    double *pdfMax, double *pdfMean,
+                                    double *pdfStdDev) -> CPLErr
+{
+    double adfStats[4] = {0.0, 0.0, 0.0, 0.0};
+
+    if (!ReadMapStatistics(adfStats) && !ReadStatisticsFile(adfStats))
+    {
+        // not computed again if already known
+        const bool bKnown = GetMetadataItem("STATISTICS_MEAN") != nullptr;
+        if (bKnown || !bForce || bApproxOK)
+            return GDALRasterBand::GetStatistics(
+                bApproxOK, bForce, pdfMin, pdfMax, pdfMean, pdfStdDev);
+
+        GRASSRowStatistics oStats;
+        if (ScanRows(oStats, nullptr, nullptr) != CE_None)
+            return CE_Failure;
+        if (oStats.nCount == 0)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "GRASS: No non null cell in %s@%s", osCellName.c_str(),
+                     osMapset.c_str());
+            return CE_Failure;
+        }
+
+        adfStats[0] = oStats.dfMin;
+        adfStats[1] = oStats.dfMax;
+        adfStats[2] = oStats.dfMean;
+        adfStats[3] = oStats.GetStdDev();
+        SetStatistics(adfStats[0], adfStats[1], adfStats[2], adfStats[3]);
+        SetMetadataItem("STATISTICS_VALID_PERCENT",
+                        CPLSPrintf("%.4g", 100.0 * oStats.nCount /
+                                               nRasterXSize / nRasterYSize));
+        WriteStatisticsFile(adfStats);
+    }
+    else
+    {
+        SetStatistics(adfStats[0], adfStats[1], adfStats[2], adfStats[3]);
+    }
+
+    if (pdfMin)
+        *pdfMin = adfStats[0];
+    if (pdfMax)
+        *pdfMax = adfStats[1];
+    if (pdfMean)
+        *pdfMean = adfStats[2];
+    if (pdfStdDev)
+        *pdfStdDev = adfStats[3];
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                            GetHistogram()                            */
+/************************************************************************/
+
+auto GRASSRasterBand::GetHistogram(double dfMin, double dfMax, int nBuckets,
+                                   GUIntBig *panHistogram,
+                                   int bIncludeOutOfRange, int bApproxOK,
+                                   GDALProgressFunc pfnProgress,
+                                   void *pProgressData) -> CPLErr
+{
+    // approximate histograms are computed from overviews or samples
+    if (bApproxOK || nBuckets < 1 || !(dfMax > dfMin))
+        return GDALRasterBand::GetHistogram(
+            dfMin, dfMax, nBuckets, panHistogram, bIncludeOutOfRange,
+            bApproxOK, pfnProgress, pProgressData);
+
+    GRASSRowStatistics oStats;
+    oStats.SetHistogram(dfMin, dfMax, nBuckets, bIncludeOutOfRange != 0);
+    if (ScanRows(oStats, pfnProgress, pProgressData) != CE_None)
+        return CE_Failure;
+
+    std::copy(oStats.anHistogram.begin(), oStats.anHistogram.end(),
+              panHistogram);
+    return CE_None;
+}
+
+/************************************************************************/
+/*                              ScanRows()                              */
+/*                                                                      */
+/* Accumulate all the rows of the band into oStats, leaving the GRASS   */
+/* nulls out. With the native decoder, row ranges are decoded by the    */
+/* caller and GDAL_NUM_THREADS - 1 threads of the GDAL thread pool and  */
+/* merged; with WORKER_PROCESSES they are decoded in the worker         */
+/* processes.                                                           */
+/************************************************************************/
+
+auto GRASSRasterBand::ScanRows(GRASSRowStatistics &oStats,
+                               GDALProgressFunc pfnProgress,
+                               void *pProgressData) -> CPLErr
+{
+    if (!this->valid)
+        return CE_Failure;
+    PrepareReading();
+
+    if (pfnProgress == nullptr)
+        pfnProgress = GDALDummyProgress;
+
+    struct Cell_head *psDsWindow =
+        &((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo);
+    const size_t nRowBytes =
+        static_cast<size_t>(nRasterXSize) *
+        GDALGetDataTypeSizeBytes(GRASSRowDataType(nGRSType));
+
+    if (UseWorkers(psDsWindow, nRasterYSize))
+    {
+        // rows come back by ranges, only the completion is reported
+        if (ReadRowsInWorkers(psDsWindow, 0, nRasterYSize,
+                              [&](int, void *pRowData) {
+                                  oStats.AddRow(pRowData, nGRSType,
+                                                nRasterXSize);
+                              }) != CE_None)
+            return CE_Failure;
+
+        pfnProgress(1.0, nullptr, pProgressData);
+        return CE_None;
+    }
+
+    if (!bNativeRows)
+    {
+        // the GRASS libraries are not thread safe
+        auto oLock = GRASSSession::Acquire();
+        if (BeginRead(psDsWindow) != CE_None)
+            return CE_Failure;
+
+        std::vector<GByte> abyRow(nRowBytes);
+        for (int iRow = 0; iRow < nRasterYSize; iRow++)
+        {
+            if (ReadGRASSRow(psDsWindow, iRow, abyRow.data(), false) !=
+                CE_None)
+                return CE_Failure;
+
+            oStats.AddRow(abyRow.data(), nGRSType, nRasterXSize);
+
+            if (!pfnProgress((iRow + 1.0) / nRasterYSize, nullptr,
+                             pProgressData))
+            {
+                CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+                return CE_Failure;
+            }
+        }
+        return CE_None;
+    }
+
+    int nThreads = std::max(1, std::min(GetThreadCount(), nRasterYSize));
+    CPLWorkerThreadPool *poPool =
+        nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
+    if (poPool == nullptr)
+        nThreads = 1;
+
+    // ranges are claimed in turn by the threads as they are done with the
+    // previous one, several per thread to balance uneven rows
+    const int nRanges = std::min(nRasterYSize, nThreads * 4);
+    std::vector<GRASSRowStatistics> aoStats(nRanges, oStats);
+    std::atomic<int> nNextRange{0};
+    std::atomic<int> nRowsDone{0};
+    std::atomic<bool> bStop{false};
+    std::atomic<bool> bFailed{false};
+    std::mutex oMutex;
+    std::condition_variable oCond;
+    int nRangesDone = 0;
+
+    // only the caller reports the progress, of the rows of all threads
+    auto ReportProgress = [&]()
+    {
+        if (!bStop && !pfnProgress(static_cast<double>(nRowsDone) /
+                                       nRasterYSize,
+                                   nullptr, pProgressData))
+            bStop = true;
+    };
+
+    auto ScanRanges = [&](bool bCaller)
+    {
+        std::vector<GByte> abyRow(nRowBytes);
+        int iRange = 0;
+        while (!bStop && (iRange = nNextRange++) < nRanges)
+        {
+            const int nFirstRow = static_cast<int>(
+                static_cast<GIntBig>(nRasterYSize) * iRange / nRanges);
+            const int nEndRow = static_cast<int>(
+                static_cast<GIntBig>(nRasterYSize) * (iRange + 1) / nRanges);
+
+            for (int iRow = nFirstRow; iRow < nEndRow && !bStop; iRow++)
+            {
+                if (!ReadNativeRow(*psDsWindow, iRow, abyRow.data(), false))
+                {
+                    bFailed = true;
+                    bStop = true;
+                    break;
+                }
+                aoStats[iRange].AddRow(abyRow.data(), nGRSType, nRasterXSize);
+                nRowsDone++;
+                if (bCaller)
+                    ReportProgress();
+            }
+
+            {
+                std::lock_guard<std::mutex> oLock(oMutex);
+                nRangesDone++;
+            }
+            oCond.notify_all();
+        }
+    };
+
+    std::unique_ptr<CPLJobQueue> poQueue;
+    if (poPool != nullptr)
+    {
+        std::function<void()> pfnJob = [&]() { ScanRanges(false); };
+        auto RunJob = [](void *pData)
+        { (*static_cast<std::function<void()> *>(pData))(); };
+        poQueue = poPool->CreateJobQueue();
+        for (int i = 1; i < nThreads; i++)
+            poQueue->SubmitJob(RunJob, &pfnJob);
+        ScanRanges(true);
+
+        // wait for the ranges claimed by the pool, reporting their progress
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> oLock(oMutex);
+                if (nRangesDone >= std::min<int>(nNextRange, nRanges))
+                    break;
+                oCond.wait(oLock);
+            }
+            ReportProgress();
+        }
+        poQueue->WaitCompletion();
+    }
+    else
+    {
+        ScanRanges(true);
+    }
+
+    if (bFailed)
+        return CE_Failure;
+    if (bStop)
+    {
+        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+        return CE_Failure;
+    }
+
+    oStats = aoStats[0];
+    for (int iRange = 1; iRange < nRanges; iRange++)
+        oStats.Merge(aoStats[iRange]);
+
+    pfnProgress(1.0, nullptr, pProgressData);
+    return CE_None;
+}
+
+/************************************************************************/
+/*                        GetDefaultHistogram()                         */
+/*                                                                      */
+/* From cell_misc/<name>/histogram (r.support -h) for CELL maps, one    */
+/* bucket per category up to 256 buckets.                               */
+/************************************************************************/
+
+auto GRASSRasterBand::GetDefaultHistogram(double *pdfMin, double *pdfMax,
+                                          int *pnBuckets,
+                                          GUIntBig **ppanHistogram, int bForce,
+                                          GDALProgressFunc pfnProgress,
+                                          void *pProgressData) -> CPLErr
+{
+    VSIStatBufL sStat;
+    if (nGRSType != CELL_TYPE || !HasMapRange() ||
+        VSIStatL((GetMiscDir() + "/histogram").c_str(), &sStat) != 0)
+        return GDALRasterBand::GetDefaultHistogram(pdfMin, pdfMax, pnBuckets,
+                                                   ppanHistogram, bForce,
+                                                   pfnProgress, pProgressData);
+
+    struct Histogram sHistogram
+    {
+    };
+    {
+        auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+        auto oLock = GRASSSession::Acquire();
+        GRASSSession::SetEnv(poGDS->osGisdbase, poGDS->osLocation, osMapset);
+        if (Rast_read_histogram(osCellName.c_str(), osMapset.c_str(),
+                                &sHistogram) != 1)
+            return GDALRasterBand::GetDefaultHistogram(
+                pdfMin, pdfMax, pnBuckets, ppanHistogram, bForce, pfnProgress,
+                pProgressData);
+    }
+
+    // the buckets GDAL uses for Byte bands
+    double dfMin = -0.5;
+    double dfMax = 255.5;
+    int nBuckets = 256;
+    if (eDataType != GDT_Byte)
+    {
+        dfMin = dfCellMin - 0.5;
+        dfMax = dfCellMax + 0.5;
+        nBuckets = static_cast<int>(std::min(dfMax - dfMin, 256.0));
+    }
+
+    auto panHistogram =
+        static_cast<GUIntBig *>(VSICalloc(nBuckets, sizeof(GUIntBig)));
+    if (panHistogram == nullptr)
+    {
+        Rast_free_histogram(&sHistogram);
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "GRASS: Cannot allocate histogram");
+        return CE_Failure;
+    }
+
+    const double dfScale = nBuckets / (dfMax - dfMin);
+    for (int i = 0; i < Rast_get_histogram_num(&sHistogram); i++)
+    {
+        const CELL nCat = Rast_get_histogram_cat(i, &sHistogram);
+        const int iBucket = static_cast<int>((nCat - dfMin) * dfScale);
+        if (iBucket >= 0 && iBucket < nBuckets)
+            panHistogram[iBucket] += static_cast<GUIntBig>(
+                Rast_get_histogram_count(i, &sHistogram));
+    }
+    Rast_free_histogram(&sHistogram);
+
+    *pdfMin = dfMin;
+    *pdfMax = dfMax;
+    *pnBuckets = nBuckets;
+    *ppanHistogram = panHistogram;
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                           GetNoDataValue()                           */
+/************************************************************************/
+
+auto GRASSRasterBand::GetNoDataValue(int *pbSuccess) -> double
+{
+    if (pbSuccess)
+        *pbSuccess = TRUE;
+
+    return dfNoData;
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMetadataItem(const char *pszName,
+                                      const char *pszDomain) -> const char *
+{
+    if (pszName != nullptr && (pszDomain == nullptr || pszDomain[0] == '\0') &&
+        STARTS_WITH_CI(pszName, "COLOR_TABLE_RULE"))
+        SetColorRules();
+
+    /* Process wide counters of the raster handle pool */
+    if (pszName != nullptr && pszDomain != nullptr &&
+        EQUAL(pszDomain, "_DEBUG_"))
+    {
+        if (EQUAL(pszName, "HANDLE_POOL_HITS"))
+            return CPLSPrintf(CPL_FRMT_GUIB, nHandlePoolHits);
+        if (EQUAL(pszName, "HANDLE_POOL_MISSES"))
+            return CPLSPrintf(CPL_FRMT_GUIB, nHandlePoolMisses);
+        if (EQUAL(pszName, "ENV_SWITCHES"))
+            return CPLSPrintf(CPL_FRMT_GUIB, GRASSSession::GetEnvSwitches());
+        if (EQUAL(pszName, "ENV_SWITCHES_SKIPPED"))
+            return CPLSPrintf(CPL_FRMT_GUIB,
+                              GRASSSession::GetEnvSwitchesSkipped());
+        if (EQUAL(pszName, "SRS_CACHE_HITS"))
+            return CPLSPrintf(CPL_FRMT_GUIB, GRASSSession::GetSRSCacheHits());
+        if (EQUAL(pszName, "PREFETCHED_ROWS"))
+            return CPLSPrintf(CPL_FRMT_GUIB, nPrefetchedRows);
+        if (EQUAL(pszName, "DIRECT_IO_REQUESTS"))
+            return CPLSPrintf(CPL_FRMT_GUIB,
+                              static_cast<GUIntBig>(nDirectIORequests));
+        if (EQUAL(pszName, "DIRECT_IO_BYTES"))
+            return CPLSPrintf(CPL_FRMT_GUIB,
+                              static_cast<GUIntBig>(nDirectIOBytes));
+        if (STARTS_WITH_CI(pszName, "ROW_CACHE_"))
+        {
+            const auto sStats = GRASSRowCache::GetStatistics();
+            if (EQUAL(pszName, "ROW_CACHE_HITS"))
+                return CPLSPrintf(CPL_FRMT_GUIB, sStats.nHits);
+            if (EQUAL(pszName, "ROW_CACHE_MISSES"))
+                return CPLSPrintf(CPL_FRMT_GUIB, sStats.nMisses);
+            if (EQUAL(pszName, "ROW_CACHE_EVICTIONS"))
+                return CPLSPrintf(CPL_FRMT_GUIB, sStats.nEvictions);
+            if (EQUAL(pszName, "ROW_CACHE_BYTES"))
+                return CPLSPrintf(CPL_FRMT_GUIB,
+                                  static_cast<GUIntBig>(sStats.nBytes));
+        }
+    }
+
+    return GDALRasterBand::GetMetadataItem(pszName, pszDomain);
+}
+
+/************************************************************************/
+/*                            GetMetadata()                             */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMetadata(const char *pszDomain) -> char **
+{
+    if (pszDomain == nullptr || pszDomain[0] == '\0')
+        SetColorRules();
+
+    return GDALRasterBand::GetMetadata(pszDomain);
+}
+
+/************************************************************************/
+/*                          GetOverviewCount()                          */
+/************************************************************************/
+
+auto GRASSRasterBand::GetOverviewCount() -> int
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    if (!poGDS->PrepareOverviews())
+        return 0;
+
+    return GDALRasterBand::GetOverviewCount();
+}
+
+/************************************************************************/
+/*                            GetOverview()                             */
+/************************************************************************/
+
+auto GRASSRasterBand::GetOverview(int iOverview) -> GDALRasterBand *
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+
+    if (!poGDS->PrepareOverviews())
+        return nullptr;
+
+    return GDALRasterBand::GetOverview(iOverview);
+}
+
+/************************************************************************/
+/*                            HasNullMask()                             */
+/*                                                                      */
+/* Whether the null file describes all null cells, so that the mask can */
+/* be read from it. Without null file CELL maps have 0 as null.         */
+/************************************************************************/
+
+auto GRASSRasterBand::HasNullMask() -> bool
+{
+    if (bNullMaskChecked)
+        return poNullMask != nullptr;
+    bNullMaskChecked = true;
+
+    if (OpenNative() && poNative->HasNullFile())
+        poNullMask.reset(new GRASSNullMaskBand(this));
+    else
+        CPLDebug("GRASS", "No null file mask for %s@%s", osCellName.c_str(),
+                 osMapset.c_str());
+
+    return poNullMask != nullptr;
+}
+
+/************************************************************************/
+/*                            GetMaskBand()                             */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMaskBand() -> GDALRasterBand *
+{
+    if (HasNullMask())
+        return poNullMask.get();
+
+    return GDALRasterBand::GetMaskBand();
+}
+
+/************************************************************************/
+/*                            GetMaskFlags()                            */
+/************************************************************************/
+
+auto GRASSRasterBand::GetMaskFlags() -> int
+{
+    if (HasNullMask())
+        return 0;
+
+    return GDALRasterBand::GetMaskFlags();
+}
+
+/************************************************************************/
+/*                             AdviseRead()                             */
+/*                                                                      */
+/* Start decoding the rows of a full resolution read in advance. Other  */
+/* reads are resampled from rows they decode themselves.                */
+/************************************************************************/
+
+auto GRASSRasterBand::AdviseRead(int /*nXOff*/, int nYOff, int nXSize,
+                                 int nYSize, int nBufXSize, int nBufYSize,
+                                 GDALDataType /*eBufType*/,
+                                 char ** /*papszOptions*/) -> CPLErr
+{
+    if (valid && nBufXSize == nXSize && nBufYSize == nYSize &&
+        GetMappedData() == nullptr &&
+        !(poPrefetcher && poPrefetcher->Covers(nYOff)))
+    {
+        StartPrefetch(nYOff, nYOff + nYSize);
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                           StartPrefetch()                            */
+/*                                                                      */
+/* Decode rows nFirstRow to nEndRow - 1 of the region in a background   */
+/* thread, ahead of the reader. All the bands of the process share      */
+/* GRASS_PREFETCH_MB megabytes and GRASS_PREFETCH_THREADS threads; the  */
+/* rows of a band are read by the caller when none are left.            */
+/************************************************************************/
+
+void GRASSRasterBand::StartPrefetch(int nFirstRow, int nEndRow)
+{
+    auto poGDS = dynamic_cast<GRASSDataset *>(poDS);
+    const int nMaxMB = atoi(CPLGetConfigOption("GRASS_PREFETCH_MB", "64"));
+    const int nMaxThreads =
+        atoi(CPLGetConfigOption("GRASS_PREFETCH_THREADS", "4"));
+
+    // worker processes decode in parallel already
+    if (nFirstRow >= nEndRow || nMaxMB <= 0 || nMaxThreads <= 0 ||
+        poGDS->bWorkerProcesses)
+        return;
+
+    // the previous reader is stopped and its share given back first
+    poPrefetcher.reset();
+    poPrefetcher.reset(GRASSRowPrefetcher::Start(
+        [this, poGDS](int nRow, void *pRow)
+        {
+            GRASSSession::Lock oLock;
+            if (!bNativeRows)
+                oLock = GRASSSession::Acquire();
+
+            return BeginRead(&(poGDS->sCellInfo)) == CE_None &&
+                   ReadGRASSRow(&(poGDS->sCellInfo), nRow, pRow) == CE_None;
+        },
+        static_cast<size_t>(nRasterXSize) *
+            GDALGetDataTypeSizeBytes(GRASSRowDataType(nGRSType)),
+        nFirstRow, nEndRow, static_cast<size_t>(nMaxMB) * 1024 * 1024,
+        nMaxThreads));
+
+    if (poPrefetcher)
+        CPLDebug("GRASS", "Prefetching rows %d to %d of %s", nFirstRow,
+                 nEndRow - 1, osCellName.c_str());
+}
+
+/************************************************************************/
+/*                          TakePrefetchedRow()                         */
+/*                                                                      */
+/* Copy nCols cells from nXOff of row nRow of the region, decoded in    */
+/* advance, false if the row was not prefetched.                        */
+/************************************************************************/
+
+auto GRASSRasterBand::TakePrefetchedRow(int nRow, int nXOff, int nCols,
+                                        void *pRow) -> bool
+{
+    if (!poPrefetcher)
+        return false;
+
+    const int nCellSize = GDALGetDataTypeSizeBytes(GRASSRowDataType(nGRSType));
+    if (nXOff == 0 && nCols == nRasterXSize)
+    {
+        if (!poPrefetcher->Take(nRow, pRow))
+            return false;
+    }
+    else
+    {
+        abyPrefetchRow.resize(static_cast<size_t>(nRasterXSize) * nCellSize);
+        if (!poPrefetcher->Take(nRow, abyPrefetchRow.data()))
+            return false;
+        memcpy(pRow,
+               abyPrefetchRow.data() + static_cast<size_t>(nXOff) * nCellSize,
+               static_cast<size_t>(nCols) * nCellSize);
+    }
+
+    nPrefetchedRows++;
+    return true;
+}
+
+/************************************************************************/
+/*                         GRASSNullMaskBand()                          */
+/************************************************************************/
+
+GRASSNullMaskBand::GRASSNullMaskBand(GRASSRasterBand *poParentIn)
+    : poParent(poParentIn)
+{
+    poDS = poParent->poDS;
+    nBand = 0;
+    nRasterXSize = poParent->nRasterXSize;
+    nRasterYSize = poParent->nRasterYSize;
+    eDataType = GDT_Byte;
+    nBlockXSize = poParent->nBlockXSize;
+    nBlockYSize = poParent->nBlockYSize;
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+auto GRASSNullMaskBand::IReadBlock(int /*nBlockXOff*/, int nBlockYOff,
+                                   void *pImage) -> CPLErr
+{
+    const struct Cell_head &sWindow =
+        dynamic_cast<GRASSDataset *>(poDS)->sCellInfo;
+    const int nFirstRow = nBlockYOff * nBlockYSize;
+    const int nRows = std::min(nBlockYSize, nRasterYSize - nFirstRow);
+
+    for (int i = 0; i < nRows; i++)
+    {
+        if (!poParent->poNative->ReadNullMask(
+                sWindow, nFirstRow + i,
+                static_cast<GByte *>(pImage) +
+                    static_cast<size_t>(i) * nBlockXSize))
+            return CE_Failure;
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             GRASSDataset                             */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                            GRASSDataset()                            */
+/************************************************************************/
+
+GRASSDataset::GRASSDataset(GRASSRasterPath &gpath)
+    : osGisdbase(gpath.gisdbase), osLocation(gpath.location),
+      osElement(gpath.element)
+{
+}
+
+/************************************************************************/
+/*                           ~GRASSDataset()                            */
+/************************************************************************/
+
+GRASSDataset::~GRASSDataset()
+{
+    // prefetching threads read the region, stop them before it goes
+    for (int i = 1; i <= nBands; i++)
+    {
+        auto poBand = dynamic_cast<GRASSRasterBand *>(GetRasterBand(i));
+        if (poBand)
+            poBand->poPrefetcher.reset();
+    }
+
+    if (m_poSRS != nullptr)
+        m_poSRS->Release();
+}
+
+/************************************************************************/
+/*                          GetSpatialRef()                             */
+/************************************************************************/
+
+auto GRASSDataset::GetSpatialRef() const -> const OGRSpatialReference *
+{
+    return m_poSRS;
+}
+
+/************************************************************************/
+/*                          GetGeoTransform()                           */
+/************************************************************************/
+
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 12, 0)
+auto GRASSDataset::GetGeoTransform(GDALGeoTransform &gt) const -> CPLErr
+{
+    gt = m_gt;
+
+    return CE_None;
+}
+#else
+auto GRASSDataset::GetGeoTransform(double *padfGeoTransform) -> CPLErr
+{
+    memcpy(padfGeoTransform, m_gt.data(), sizeof(double) * 6);
+
+    return CE_None;
+}
+#endif
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/*                                                                      */
+/* Read all requested bands row by row in one pass, with the window set */
+/* and the rasters opened once, directly into the (BIP, BIL or BSQ)     */
+/* buffer. Requests served better per band are left to the default     */
+/* implementation: resampling, overviews, memory mapped bands, worker   */
+/* processes, or more bands than raster handles.                        */
+/************************************************************************/
+
+auto GRASSDataset::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff,
+                             int nXSize, int nYSize, void *pData,
+                             int nBufXSize, int nBufYSize,
+                             GDALDataType eBufType, int nBandCount,
+                             BANDMAP_TYPE panBandMap, GSpacing nPixelSpace,
+                             GSpacing nLineSpace, GSpacing nBandSpace,
+                             GDALRasterIOExtraArg *psExtraArg) -> CPLErr
+{
+    std::vector<GRASSRasterBand *> apoBands;
+    bool bPerBand = eRWFlag != GF_Read || nBandCount < 2 ||
+                    nBandCount > GetMaxOpenRasters() || bWorkerProcesses;
+
+    for (int i = 0; i < nBandCount && !bPerBand; i++)
+    {
+        auto poBand =
+            dynamic_cast<GRASSRasterBand *>(GetRasterBand(panBandMap[i]));
+        if (poBand == nullptr || !poBand->valid ||
+            poBand->GetMappedData() != nullptr ||
+            !poBand->UseDirectIO(nYOff, nXSize, nYSize, nBufXSize, nBufYSize))
+            bPerBand = true;
+        else if ((nBufXSize != nXSize || nBufYSize != nYSize) &&
+                 (psExtraArg->eResampleAlg != GRIORA_NearestNeighbour ||
+                  poBand->GetOverviewCount() > 0))
+            bPerBand = true;
+        apoBands.push_back(poBand);
+    }
+
+    if (bPerBand)
+        return GDALDataset::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                      pData, nBufXSize, nBufYSize, eBufType,
+                                      nBandCount, panBandMap, nPixelSpace,
+                                      nLineSpace, nBandSpace, psExtraArg);
+
+    struct Cell_head sWindow
+    {
+    };
+    GetReadWindow(&sCellInfo, nXOff, nYOff, nXSize, nYSize, nBufXSize,
+                  nBufYSize, &sWindow);
+
+    bool bAllNative = true;
+    for (auto poBand : apoBands)
+    {
+        poBand->CountDirectIO(nBufXSize, nBufYSize, eBufType);
+        bAllNative = bAllNative && poBand->bNativeRows;
+    }
+
+    // the window is set once, only the mapsets of the bands are switched;
+    // the GRASS libraries are not thread safe
+    GRASSSession::Lock oLock;
+    if (!bAllNative)
+        oLock = GRASSSession::Acquire();
+
+    for (auto poBand : apoBands)
+    {
+        if (poBand->BeginRead(&sWindow) != CE_None)
+            return CE_Failure;
+    }
+
+    std::vector<GByte> abyRow(static_cast<size_t>(nBufXSize) * sizeof(DCELL));
+
+    for (int row = 0; row < nBufYSize; row++)
+    {
+        for (int i = 0; i < nBandCount; i++)
+        {
+            GRASSRasterBand *poBand = apoBands[i];
+
+            if (poBand->ReadGRASSRow(&sWindow, row, abyRow.data(), false) !=
+                CE_None)
+                return CE_Failure;
+
+            GRASSCopyRow(abyRow.data(), poBand->nGRSType,
+                         static_cast<GByte *>(pData) + row * nLineSpace +
+                             i * nBandSpace,
+                         eBufType, static_cast<int>(nPixelSpace), nBufXSize,
+                         poBand->dfNoData);
+        }
+
+        if (!RasterIOProgress(psExtraArg, (row + 1.0) / nBufYSize))
+            return CE_Failure;
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                          BeginAsyncReader()                          */
+/*                                                                      */
+/* Start decoding a nearest neighbour window in a background thread.    */
+/* The ROW_ORDER=TOP_DOWN/COARSE_TO_FINE option selects the order of    */
+/* the buffer rows (default TOP_DOWN).                                  */
+/************************************************************************/
+
+auto GRASSDataset::BeginAsyncReader(int nXOff, int nYOff, int nXSize,
+                                    int nYSize, void *pBuf, int nBufXSize,
+                                    int nBufYSize, GDALDataType eBufType,
+                                    int nBandCount, int *panBandMap,
+                                    int nPixelSpace, int nLineSpace,
+                                    int nBandSpace, char **papszOptions)
+    -> GDALAsyncReader *
+{
+    if (nXOff < 0 || nYOff < 0 || nXSize < 1 || nYSize < 1 ||
+        nXOff + nXSize > nRasterXSize || nYOff + nYSize > nRasterYSize ||
+        nBufXSize < 1 || nBufYSize < 1 || nBandCount < 1 || pBuf == nullptr)
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "GRASS: Invalid asynchronous read request");
+        return nullptr;
+    }
+
+    std::vector<GRASSRasterBand *> apoBands;
+    for (int i = 0; i < nBandCount; i++)
+    {
+        const int nBand = panBandMap ? panBandMap[i] : i + 1;
+        auto poBand =
+            nBand >= 1 && nBand <= nBands
+                ? dynamic_cast<GRASSRasterBand *>(GetRasterBand(nBand))
+                : nullptr;
+        if (poBand == nullptr || !poBand->valid)
+        {
+            CPLError(CE_Failure, CPLE_IllegalArg,
+                     "GRASS: Invalid band %d for asynchronous read", nBand);
+            return nullptr;
+        }
+        poBand->PrepareReading();
+        apoBands.push_back(poBand);
+    }
+
+    if (nPixelSpace == 0)
+        nPixelSpace = GDALGetDataTypeSizeBytes(eBufType);
+    if (nLineSpace == 0)
+        nLineSpace = nPixelSpace * nBufXSize;
+    if (nBandSpace == 0)
+        nBandSpace = nLineSpace * nBufYSize;
+
+    const char *pszRowOrder =
+        CSLFetchNameValueDef(papszOptions, "ROW_ORDER", "TOP_DOWN");
+    auto poReader = new GRASSAsyncReader(
+        this, apoBands, EQUAL(pszRowOrder, "COARSE_TO_FINE"), nXOff, nYOff,
+        nXSize, nYSize, pBuf, nBufXSize, nBufYSize, eBufType, nPixelSpace,
+        nLineSpace, nBandSpace);
+    poReader->Start();
+    return poReader;
+}
+
+/************************************************************************/
+/*                           GetSourceStamp()                           */
+/*                                                                      */
+/* Stamp of the map files of the bands (see GetMapFilesStamp()) and of  */
+/* the REF file of a group, empty if a map cannot be found.             */
+/************************************************************************/
+
+auto GRASSDataset::GetSourceStamp() -> std::string
+{
+    std::string osStamp;
+
+    for (int iBand = 1; iBand <= nBands; iBand++)
+    {
+        auto poBand = dynamic_cast<GRASSRasterBand *>(GetRasterBand(iBand));
+        if (poBand->GetMapMTime() < 0)
+            return std::string();
+        osStamp += poBand->osCellName + "@" + poBand->osMapset + " " +
+                   poBand->GetMapStamp() + "\n";
+    }
+
+    if (osElement == "group")
+    {
+        VSIStatBufL sStat;
+        if (VSIStatL((osOverviewDir + "/REF").c_str(), &sStat) != 0)
+            return std::string();
+        osStamp += CPLSPrintf("REF " CPL_FRMT_GIB ":" CPL_FRMT_GIB "\n",
+                              static_cast<GIntBig>(sStat.st_mtime),
+                              static_cast<GIntBig>(sStat.st_size));
+    }
+
+    return osStamp;
+}
+
+/************************************************************************/
+/*                        GetOverviewStampFile()                        */
+/************************************************************************/
+
+auto GRASSDataset::GetOverviewStampFile() const -> std::string
+{
+    return osOverviewDir + "/overviews.stamp";
+}
+
+/************************************************************************/
+/*                         PrepareOverviews()                           */
+/*                                                                      */
+/* Decide once whether the overview file can be used: it must have been */
+/* built from the maps as they are now. With OVERVIEWS=BUILD a missing  */
+/* or stale file is (re)built.                                          */
+/************************************************************************/
+
+auto GRASSDataset::PrepareOverviews() -> bool
+{
+    if (bOverviewsChecked)
+        return bOverviewsUsable;
+    bOverviewsChecked = true;
+
+    if (osOverviewFile.empty())
+        return false;
+
+    const std::string osSourceStamp = GetSourceStamp();
+    VSIStatBufL sStat;
+    const bool bExists = VSIStatL(osOverviewFile.c_str(), &sStat) == 0;
+
+    if (bExists && !osSourceStamp.empty())
+    {
+        std::string osStamp;
+        VSILFILE *fp = VSIFOpenL(GetOverviewStampFile().c_str(), "rb");
+        if (fp != nullptr)
+        {
+            const char *pszLine = nullptr;
+            while ((pszLine = CPLReadLineL(fp)) != nullptr)
+                osStamp += std::string(pszLine) + "\n";
+            VSIFCloseL(fp);
+        }
+        if (osStamp == osSourceStamp)
+        {
+            bOverviewsUsable = true;
+            return true;
+        }
+    }
+
+    if (bExists)
+    {
+        CPLDebug("GRASS", "Overviews %s were built from other maps, ignored",
+                 osOverviewFile.c_str());
+    }
+
+    if (!bBuildOverviews || osSourceStamp.empty())
+        return false;
+
+    if (bExists && VSIUnlink(osOverviewFile.c_str()) != 0)
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "GRASS: Cannot remove outdated overviews %s",
+                 osOverviewFile.c_str());
+        return false;
+    }
+
+    bOverviewsUsable = BuildInternalOverviews();
+    return bOverviewsUsable;
+}
+
+/************************************************************************/
+/*                          IBuildOverviews()                           */
+/*                                                                      */
+/* Record the stamp of the maps next to the overviews built by the      */
+/* driver or by gdaladdo.                                               */
+/************************************************************************/
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 6, 0)
+auto GRASSDataset::IBuildOverviews(const char *pszResampling, int nOverviews,
+                                   const int *panOverviewList, int nListBands,
+                                   const int *panBandList,
+                                   GDALProgressFunc pfnProgress,
+                                   void *pProgressData,
+                                   CSLConstList papszOptions) -> CPLErr
+#else
+auto GRASSDataset::IBuildOverviews(const char *pszResampling, int nOverviews,
+                                   int *panOverviewList, int nListBands,
+                                   int *panBandList,
+                                   GDALProgressFunc pfnProgress,
+                                   void *pProgressData) -> CPLErr
+#endif
+{
+    // stamped before reading the maps, a map changed meanwhile is stale
+    const std::string osStamp = GetSourceStamp();
+    const std::string osStampFile = GetOverviewStampFile();
+    VSIUnlink(osStampFile.c_str());
+
+    const CPLErr eErr = GDALDataset::IBuildOverviews(
+        pszResampling, nOverviews, panOverviewList, nListBands, panBandList,
+        pfnProgress, pProgressData
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 6, 0)
+        ,
+        papszOptions
+#endif
+    );
+    if (eErr != CE_None || nOverviews == 0 || osStamp.empty())
+        return eErr;
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    VSILFILE *fp = VSIFOpenL(osStampFile.c_str(), "wb");
+    bool bOK = fp != nullptr && VSIFWriteL(osStamp.data(), 1, osStamp.size(),
+                                           fp) == osStamp.size();
+    if (fp != nullptr)
+        bOK = VSIFCloseL(fp) == 0 && bOK;
+    CPLPopErrorHandler();
+
+    if (!bOK)
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "GRASS: Cannot write %s, the overviews will not be used",
+                 osStampFile.c_str());
+        VSIUnlink(osStampFile.c_str());
+        return eErr;
+    }
+
+    bOverviewsChecked = true;
+    bOverviewsUsable = true;
+    return eErr;
+}
+
+/************************************************************************/
+/*                       BuildInternalOverviews()                       */
+/*                                                                      */
+/* Build power of two levels until the overview fits in 256x256.        */
+/* Categories (CELL maps) are subsampled, floating point maps averaged. */
+/************************************************************************/
+
+auto GRASSDataset::BuildInternalOverviews() -> bool
+{
+    std::vector<int> anLevels;
+    for (int nFactor = 2;
+         (nRasterXSize + nFactor / 2 - 1) / (nFactor / 2) > 256 ||
+         (nRasterYSize + nFactor / 2 - 1) / (nFactor / 2) > 256;
+         nFactor *= 2)
+    {
+        anLevels.push_back(nFactor);
+    }
+    if (anLevels.empty())
+        return false;
+
+    const char *pszResampling = "AVERAGE";
+    for (int iBand = 1; iBand <= nBands; iBand++)
+    {
+        auto poBand = dynamic_cast<GRASSRasterBand *>(GetRasterBand(iBand));
+        if (poBand->nGRSType == CELL_TYPE)
+            pszResampling = "NEAREST";
+    }
+
+    CPLDebug("GRASS", "Building %d overview levels in %s",
+             static_cast<int>(anLevels.size()), osOverviewFile.c_str());
+
+    VSIMkdirRecursive(osOverviewDir.c_str(), 0755);
+
+    // the overview bands are looked up while they are computed
+    bOverviewsUsable = true;
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const CPLErr eErr = BuildOverviews(
+        pszResampling, static_cast<int>(anLevels.size()), anLevels.data(), 0,
+        nullptr, nullptr, nullptr);
+    CPLPopErrorHandler();
+
+    if (eErr != CE_None)
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "GRASS: Cannot build overviews in %s: %s",
+                 osOverviewFile.c_str(), CPLGetLastErrorMsg());
+        VSIUnlink(osOverviewFile.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                         GetManifestHeader()                          */
+/*                                                                      */
+/* First line of the manifest: format version, modification time and    */
+/* size of the REF file of the group.                                   */
+/************************************************************************/
+
+auto GRASSDataset::GetManifestHeader() -> std::string
+{
+    VSIStatBufL sStat;
+    if (VSIStatL((osGroupDir + "/REF").c_str(), &sStat) != 0)
+        return "GDAL_GRASS_MANIFEST 2 -1:-1";
+    return CPLSPrintf("GDAL_GRASS_MANIFEST 2 " CPL_FRMT_GIB ":" CPL_FRMT_GIB,
+                      static_cast<GIntBig>(sStat.st_mtime),
+                      static_cast<GIntBig>(sStat.st_size));
+}
+
+/************************************************************************/
+/*                            ReadManifest()                            */
+/*                                                                      */
+/* Band headers of the maps of the group from the manifest, if it lists */
+/* these maps and the group and the map files are in the state it was   */
+/* written from (see GetMapFilesStamp()).                               */
+/************************************************************************/
+
+auto GRASSDataset::ReadManifest(char **papszCells, char **papszMapsets,
+                                std::vector<GRASSBandInfo> &asInfos) -> bool
+{
+    const std::string osManifestFile = osGroupDir + "/gdal_manifest";
+    VSIStatBufL sStat;
+    if (!bUseManifest || VSIStatL(osManifestFile.c_str(), &sStat) != 0)
+        return false;
+
+    char **papszLines = CSLLoad(osManifestFile.c_str());
+    bool bValid = papszLines != nullptr &&
+                  CSLCount(papszLines) == CSLCount(papszCells) + 1 &&
+                  GetManifestHeader() == papszLines[0];
+
+    for (int iBand = 0; bValid && papszCells[iBand] != nullptr; iBand++)
+    {
+        char **papszFields =
+            CSLTokenizeString2(papszLines[iBand + 1], " ", 0);
+        bValid = CSLCount(papszFields) == 13 &&
+                 strcmp(papszFields[0], papszCells[iBand]) == 0 &&
+                 strcmp(papszFields[1], papszMapsets[iBand]) == 0;
+        if (bValid)
+        {
+            GRASSBandInfo sInfo;
+            sInfo.nGRSType = atoi(papszFields[2]);
+            sInfo.nFormat = atoi(papszFields[3]);
+            sInfo.nCompressed = atoi(papszFields[4]);
+            sInfo.bHaveMinMax = atoi(papszFields[5]) != 0;
+            sInfo.dfMin = CPLAtof(papszFields[6]);
+            sInfo.dfMax = CPLAtof(papszFields[7]);
+            sInfo.bMapRegion = atoi(papszFields[8]) != 0;
+
+            const std::string osStamp = CPLSPrintf(
+                "%s %s %s %s", papszFields[9], papszFields[10],
+                papszFields[11], papszFields[12]);
+            bValid = osStamp ==
+                     GetMapFilesStamp(osGisdbase + "/" + osLocation + "/" +
+                                          papszMapsets[iBand],
+                                      papszCells[iBand], sInfo.nGRSType);
+            asInfos.push_back(sInfo);
+        }
+        CSLDestroy(papszFields);
+    }
+    CSLDestroy(papszLines);
+
+    if (!bValid)
+    {
+        CPLDebug("GRASS", "Group manifest %s is outdated, ignored",
+                 osManifestFile.c_str());
+        asInfos.clear();
+    }
+
+    return bValid;
+}
+
+/************************************************************************/
+/*                           WriteManifest()                            */
+/************************************************************************/
+
+void GRASSDataset::WriteManifest(char **papszCells, char **papszMapsets,
+                                 const std::vector<GRASSBandInfo> &asInfos)
+{
+    const std::string osManifestFile = osGroupDir + "/gdal_manifest";
+    std::string osManifest = GetManifestHeader() + "\n";
+
+    for (int iBand = 0; papszCells[iBand] != nullptr; iBand++)
+    {
+        const GRASSBandInfo &sInfo = asInfos[iBand];
+        osManifest += CPLSPrintf(
+            "%s %s %d %d %d %d %.17g %.17g %d ", papszCells[iBand],
+            papszMapsets[iBand], sInfo.nGRSType, sInfo.nFormat,
+            sInfo.nCompressed, sInfo.bHaveMinMax ? 1 : 0, sInfo.dfMin,
+            sInfo.dfMax, sInfo.bMapRegion ? 1 : 0);
+        osManifest +=
+            GetMapFilesStamp(osGisdbase + "/" + osLocation + "/" +
+                                 papszMapsets[iBand],
+                             papszCells[iBand], sInfo.nGRSType) +
+            "\n";
+    }
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    VSILFILE *fp = VSIFOpenL(osManifestFile.c_str(), "wb");
+    bool bOK = fp != nullptr && VSIFWriteL(osManifest.data(), 1,
+                                           osManifest.size(),
+                                           fp) == osManifest.size();
+    if (fp != nullptr)
+        bOK = VSIFCloseL(fp) == 0 && bOK;
+    CPLPopErrorHandler();
+
+    if (!bOK)
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "GRASS: Cannot write group manifest %s",
+                 osManifestFile.c_str());
+        VSIUnlink(osManifestFile.c_str());
+    }
+}
+
+/************************************************************************/
+/*                         InitGRASSLibraries()                         */
+/*                                                                      */
+/* Set GISBASE if missing and initialise the GRASS libraries, with the  */
+/* GRASSSession lock held.                                              */
+/************************************************************************/
+
+static auto InitGRASSLibraries() -> bool
+{
+    // GISBASE is path to the directory where GRASS is installed,
+    if (!getenv("GISBASE"))
+    {
+        static char *gisbaseEnv = nullptr;
+        const char *gisbase = GRASS_GISBASE;
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "GRASS warning: GISBASE "
+                 "environment variable was not set, using:\n%s",
+                 gisbase);
+        std::array<char, BUFF_SIZE> buf{};
+        int res = std::snprintf(buf.data(), BUFF_SIZE, "GISBASE=%s", gisbase);
+        if (res >= BUFF_SIZE)
+        {
+            CPLError(
+                CE_Warning, CPLE_AppDefined,
+                "GRASS warning: GISBASE environment variable was too long.\n");
+            return false;
+        }
+
+        CPLFree(gisbaseEnv);
+        gisbaseEnv = CPLStrdup(buf.data());
+        putenv(gisbaseEnv);
+    }
+
+    // Init GRASS libraries (required), once per process
+    GRASSSession::Init();
+
+    return true;
+}
+
+/************************************************************************/
+/*                              Identify()                              */
+/*                                                                      */
+/* Only looks at the path and stats the PERMANENT mapset of the         */
+/* location, the GRASS libraries are set up by Open().                  */
+/************************************************************************/
+
+auto GRASSDataset::Identify(GDALOpenInfo *poOpenInfo) -> int
+{
+    if (STARTS_WITH_CI(poOpenInfo->pszFilename, "GRASS:"))
+        return TRUE;
+
+    /* -------------------------------------------------------------------- */
+    /*      Does this even look like a grass file path?                     */
+    /* -------------------------------------------------------------------- */
+    if (!poOpenInfo->bStatOK ||
+        (strstr(poOpenInfo->pszFilename, "/cellhd/") == nullptr &&
+         strstr(poOpenInfo->pszFilename, "/group/") == nullptr))
+        return FALSE;
+
+    // a cellhd file or a group directory
+    GRASSRasterPath gp = GRASSRasterPath(poOpenInfo->pszFilename);
+    const bool bIsDirectory = poOpenInfo->bIsDirectory != FALSE;
+    if (!gp.isValid() || gp.isCellHD() == bIsDirectory)
+        return FALSE;
+
+    VSIStatBufL sStat;
+    const std::string osPermanent =
+        gp.gisdbase + "/" + gp.location + "/PERMANENT";
+    return VSIStatL(osPermanent.c_str(), &sStat) == 0 &&
+           VSI_ISDIR(sStat.st_mode);
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+auto GRASSDataset::Open(GDALOpenInfo *poOpenInfo) -> GDALDataset *
+{
+    char **papszCells = nullptr;
+    char **papszMapsets = nullptr;
+
+    if (!Identify(poOpenInfo))
+        return nullptr;
+
+    if (STARTS_WITH_CI(poOpenInfo->pszFilename, "GRASS:"))
+        return GRASSMapsetDataset::Open(poOpenInfo);
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
+    // only the space time datasets of a mapset are multidimensional
+    if ((poOpenInfo->nOpenFlags & GDAL_OF_MULTIDIM_RASTER) != 0)
+        return nullptr;
+#endif
+
+    auto oLock = GRASSSession::Acquire();
+    if (!InitGRASSLibraries())
+        return nullptr;
+
+    GRASSRasterPath gp = GRASSRasterPath(poOpenInfo->pszFilename);
+
+    /* -------------------------------------------------------------------- */
+    /*      Check element name                                              */
+    /* -------------------------------------------------------------------- */
+    if (!gp.isValid())
+    {
+        return nullptr;
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Set GRASS variables                                             */
+    /* -------------------------------------------------------------------- */
+
+    // group is searched only in current mapset. Rasters of other
+    // locations are closed by GRASSRasterBand::ReleaseHandles().
+    GRASSSession::SetEnv(gp.gisdbase, gp.location, gp.mapset);
+
+    /* -------------------------------------------------------------------- */
+    /*      Check if this is a valid grass cell.                            */
+    /* -------------------------------------------------------------------- */
+    if (gp.isCellHD())
+    {
+
+        if (G_find_file2("cell", gp.name.c_str(), gp.mapset.c_str()) == nullptr)
+        {
+            return nullptr;
+        }
+
+        papszMapsets = CSLAddString(papszMapsets, gp.mapset.c_str());
+        papszCells = CSLAddString(papszCells, gp.name.c_str());
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Check if this is a valid GRASS imagery group.                   */
+    /* -------------------------------------------------------------------- */
+    else
+    {
+        struct Ref ref
+        {
+        };
+
+        I_init_group_ref(&ref);
+        bool has_group_ref = I_get_group_ref(gp.name.c_str(), &ref);
+        if (!has_group_ref || ref.nfiles <= 0)
+        {
+            return nullptr;
+        }
+
+        for (int iRef = 0; iRef < ref.nfiles; iRef++)
+        {
+            papszCells = CSLAddString(papszCells, ref.file[iRef].name);
+            papszMapsets = CSLAddString(papszMapsets, ref.file[iRef].mapset);
+            GRASSSession::AddMapsetToSearchPath(ref.file[iRef].mapset);
+        }
+
+        I_free_group_ref(&ref);
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Create a corresponding GDALDataset.                             */
+    /* -------------------------------------------------------------------- */
+    auto poDS = new GRASSDataset(gp);
+
+    /* notdef: should only allow read access to an existing cell, right? */
+    poDS->eAccess = poOpenInfo->eAccess;
+
+    const char *pszBlockYSize = CSLFetchNameValueDef(
+        poOpenInfo->papszOpenOptions, "BLOCK_YSIZE", "1");
+    if (EQUAL(pszBlockYSize, "AUTO"))
+    {
+        poDS->nBlockYSizeRequest = 0;
+    }
+    else
+    {
+        poDS->nBlockYSizeRequest = atoi(pszBlockYSize);
+        if (poDS->nBlockYSizeRequest < 1)
+        {
+            CPLError(CE_Warning, CPLE_IllegalArg,
+                     "GRASS: Invalid BLOCK_YSIZE=%s, using 1", pszBlockYSize);
+            poDS->nBlockYSizeRequest = 1;
+        }
+    }
 
-    // Reset window because IRasterIO could be previously called.
-    if (ResetReading(&((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo)) !=
-        CE_None)
+    poDS->bNativeDecoder = CPLFetchBool(poOpenInfo->papszOpenOptions,
+                                        "NATIVE_DECODER", false);
+    poDS->bWorkerProcesses = CPLFetchBool(poOpenInfo->papszOpenOptions,
+                                          "WORKER_PROCESSES", false);
+
+    const char *pszOverviews = CSLFetchNameValueDef(
+        poOpenInfo->papszOpenOptions, "OVERVIEWS", "USE");
+    poDS->bBuildOverviews = EQUAL(pszOverviews, "BUILD");
+    if (!EQUAL(pszOverviews, "NONE"))
     {
-        return CE_Failure;
+        poDS->osOverviewDir = gp.gisdbase + "/" + gp.location + "/" +
+                              gp.mapset +
+                              (gp.isCellHD() ? "/cell_misc/" : "/group/") +
+                              gp.name;
+        poDS->osOverviewFile = poDS->osOverviewDir + "/overviews.ovr";
     }
-    // open for reading
-    if (hCell < 0)
+
+    const char *pszManifest = CSLFetchNameValueDef(
+        poOpenInfo->papszOpenOptions, "GROUP_MANIFEST", "USE");
+    if (!gp.isCellHD())
     {
-        hCell = Rast_open_old(osCellName.c_str(), osMapset.c_str());
-        if (hCell < 0)
-        {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "GRASS: Cannot open raster '%s'", osCellName.c_str());
-            return CE_Failure;
-        }
+        poDS->osGroupDir = gp.gisdbase + "/" + gp.location + "/" +
+                           gp.mapset + "/group/" + gp.name;
+        poDS->bUseManifest = !EQUAL(pszManifest, "NONE");
+        poDS->bBuildManifest = EQUAL(pszManifest, "BUILD");
     }
 
-    if (eDataType == GDT_Byte || eDataType == GDT_UInt16)
+    if (!papszCells)
     {
-        CELL *cbuf = Rast_allocate_c_buf();
-        Rast_get_c_row(hCell, cbuf, nBlockYOff);
+        return nullptr;
+    }
 
-        /* Reset NULLs */
-        for (int col = 0; col < nBlockXSize; col++)
-        {
-            if (Rast_is_c_null_value(&(cbuf[col])))
-                cbuf[col] = (CELL)dfNoData;
-        }
+    /* -------------------------------------------------------------------- */
+    /*      Capture some information from the file that is of interest.     */
+    /* -------------------------------------------------------------------- */
 
-        GDALCopyWords(static_cast<void *>(cbuf), GDT_Int32, sizeof(CELL),
-                      pImage, eDataType, GDALGetDataTypeSizeBytes(eDataType),
-                      nBlockXSize);
+    Rast_get_cellhd(papszCells[0], papszMapsets[0], &(poDS->sCellInfo));
 
-        G_free(cbuf);
-    }
-    else if (eDataType == GDT_Int32)
+    poDS->nRasterXSize = poDS->sCellInfo.cols;
+    poDS->nRasterYSize = poDS->sCellInfo.rows;
+
+    poDS->m_gt[0] = poDS->sCellInfo.west;
+    poDS->m_gt[1] = poDS->sCellInfo.ew_res;
+    poDS->m_gt[2] = 0.0;
+    poDS->m_gt[3] = poDS->sCellInfo.north;
+    poDS->m_gt[4] = 0.0;
+    poDS->m_gt[5] = -1 * poDS->sCellInfo.ns_res;
+
+    /* -------------------------------------------------------------------- */
+    /*      Try to get a projection definition.                             */
+    /* -------------------------------------------------------------------- */
+    poDS->m_poSRS = GRASSSession::GetSpatialRef();
+
+    /* -------------------------------------------------------------------- */
+    /*      Create band information objects.                                */
+    /* -------------------------------------------------------------------- */
+    std::vector<GRASSBandInfo> asInfos;
+    if (!poDS->ReadManifest(papszCells, papszMapsets, asInfos))
     {
-        Rast_get_c_row(hCell, static_cast<CELL *>(pImage), nBlockYOff);
+        for (int iBand = 0; papszCells[iBand] != nullptr; iBand++)
+        {
+            GRASSBandInfo sInfo;
+            GRASSRasterBand::ReadInfo(papszMapsets[iBand], papszCells[iBand],
+                                      &(poDS->sCellInfo), &sInfo);
+            asInfos.push_back(sInfo);
+        }
+        if (poDS->bBuildManifest)
+            poDS->WriteManifest(papszCells, papszMapsets, asInfos);
     }
-    else if (eDataType == GDT_Float32)
+
+    for (int iBand = 0; papszCells[iBand] != nullptr; iBand++)
     {
-        Rast_get_f_row(hCell, static_cast<FCELL *>(pImage), nBlockYOff);
+        std::string msets = std::string(papszMapsets[iBand]);
+        std::string cells = std::string(papszCells[iBand]);
+        auto rb = new GRASSRasterBand(poDS, iBand + 1, msets, cells,
+                                      asInfos[iBand]);
+
+        if (!rb->valid)
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "GRASS: Cannot open raster band %d", iBand);
+            delete rb;
+            delete poDS;
+            return nullptr;
+        }
+
+        poDS->SetBand(iBand + 1, rb);
     }
-    else if (eDataType == GDT_Float64)
+
+    CSLDestroy(papszCells);
+    CSLDestroy(papszMapsets);
+
+    if (!poDS->osOverviewFile.empty())
+        poDS->oOvManager.Initialize(poDS, poDS->osOverviewFile.c_str(),
+                                    nullptr, true);
+
+    /* -------------------------------------------------------------------- */
+    /*      Confirm the requested access is supported.                      */
+    /* -------------------------------------------------------------------- */
+    if (poOpenInfo->eAccess == GA_Update)
     {
-        Rast_get_d_row(hCell, static_cast<DCELL *>(pImage), nBlockYOff);
+        delete poDS;
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "The GRASS driver does not support update access to existing"
+                 " datasets.\n");
+        return nullptr;
     }
 
-    // close to avoid confusion with other GRASS raster bands
-    Rast_close(hCell);
-    hCell = -1;
-
-    return CE_None;
+    return poDS;
 }
 
 /************************************************************************/
-/*                             IRasterIO()                              */
-/*                                                                      */
+/*                          GRASSMapsetListing                          */
 /************************************************************************/
 
-auto GRASSRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff,
-                                int nXSize, int nYSize, void *pData,
-                                int nBufXSize, int nBufYSize,
-                                GDALDataType eBufType, GSpacing nPixelSpace,
-                                GSpacing nLineSpace,
-                                GDALRasterIOExtraArg * /*psExtraArg*/) -> CPLErr
+namespace
 {
-    /* GRASS library does that, we have only calculate and reset the region in map units
-     * and if the region has changed, reopen the raster */
 
-    /* Calculate the region */
-    struct Cell_head sWindow
-    {
-    };
-    struct Cell_head *psDsWindow = nullptr;
+/* Raster maps and imagery groups of a mapset, with the modification times
+ * of the mapset, cellhd and group directories they were listed at (-1 for
+ * missing directories) */
+struct GRASSMapsetListing
+{
+    std::vector<GIntBig> anMTimes{};
+    std::vector<std::string> aosCells{};
+    std::vector<std::string> aosGroups{};
+};
 
-    if (eRWFlag != GF_Read)
-        return CE_Failure;
-    if (!this->valid)
-        return CE_Failure;
+}  // namespace
 
-    psDsWindow = &((dynamic_cast<GRASSDataset *>(poDS))->sCellInfo);
+/************************************************************************/
+/*                          ListMapsetElement()                         */
+/************************************************************************/
 
-    sWindow.north = psDsWindow->north - nYOff * psDsWindow->ns_res;
-    sWindow.south = sWindow.north - nYSize * psDsWindow->ns_res;
-    sWindow.west = psDsWindow->west + nXOff * psDsWindow->ew_res;
-    sWindow.east = sWindow.west + nXSize * psDsWindow->ew_res;
-    sWindow.proj = psDsWindow->proj;
-    sWindow.zone = psDsWindow->zone;
+static auto ListMapsetElement(const std::string &osElementDir)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> aosNames;
+    const CPLStringList aosEntries(VSIReadDir(osElementDir.c_str()));
+    for (int i = 0; i < aosEntries.size(); i++)
+    {
+        if (aosEntries[i][0] != '.')
+            aosNames.push_back(aosEntries[i]);
+    }
+    std::sort(aosNames.begin(), aosNames.end());
+    return aosNames;
+}
 
-    sWindow.cols = nBufXSize;
-    sWindow.rows = nBufYSize;
+/************************************************************************/
+/*                          GetMapsetListing()                          */
+/*                                                                      */
+/* The cellhd and group directories of a mapset are only read again     */
+/* when the modification time of one of the directories changed.        */
+/************************************************************************/
 
-    /* Reset resolution */
-    G_adjust_Cell_head(&sWindow, 1, 1);
+static auto GetMapsetListing(const std::string &osMapsetDir)
+    -> GRASSMapsetListing
+{
+    static std::mutex oMutex;
+    static std::map<std::string, GRASSMapsetListing> oListings;
 
-    if (ResetReading(&sWindow) != CE_None)
+    std::vector<GIntBig> anMTimes;
+    for (const char *pszDir : {"", "/cellhd", "/group"})
     {
-        return CE_Failure;
+        VSIStatBufL sStat;
+        const std::string osDir = osMapsetDir + pszDir;
+        anMTimes.push_back(VSIStatL(osDir.c_str(), &sStat) == 0
+                               ? static_cast<GIntBig>(sStat.st_mtime)
+                               : -1);
     }
-    // open for reading
-    if (hCell < 0)
+
+    std::lock_guard<std::mutex> oLock(oMutex);
+    GRASSMapsetListing &oListing = oListings[osMapsetDir];
+    if (oListing.anMTimes != anMTimes)
     {
-        hCell = Rast_open_old(osCellName.c_str(), osMapset.c_str());
-        if (hCell < 0)
-        {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "GRASS: Cannot open raster '%s'", osCellName.c_str());
-            return CE_Failure;
-        }
+        CPLDebug("GRASS", "Listing mapset %s", osMapsetDir.c_str());
+        oListing.anMTimes = anMTimes;
+        oListing.aosCells = ListMapsetElement(osMapsetDir + "/cellhd");
+        oListing.aosGroups = ListMapsetElement(osMapsetDir + "/group");
     }
+    return oListing;
+}
 
-    /* Read Data */
-    CELL *cbuf = nullptr;
-    FCELL *fbuf = nullptr;
-    DCELL *dbuf = nullptr;
-    bool direct = false;
-
-    /* Reset space if default (0) */
-    if (nPixelSpace == 0)
-        nPixelSpace = GDALGetDataTypeSizeBytes(eBufType);
+/************************************************************************/
+/*                     GRASSMapsetDataset::Open()                       */
+/************************************************************************/
 
-    if (nLineSpace == 0)
-        nLineSpace = nBufXSize * nPixelSpace;
+auto GRASSMapsetDataset::Open(GDALOpenInfo *poOpenInfo) -> GDALDataset *
+{
+    std::string osMapsetDir = poOpenInfo->pszFilename + strlen("GRASS:");
+    while (osMapsetDir.size() > 1 && osMapsetDir.back() == '/')
+        osMapsetDir.pop_back();
+
+    // GISDBASE, LOCATION_NAME and MAPSET must all be given
+    const size_t nMapsetPos = osMapsetDir.rfind('/');
+    const size_t nLocationPos = nMapsetPos == std::string::npos ||
+                                        nMapsetPos == 0
+                                    ? std::string::npos
+                                    : osMapsetDir.rfind('/', nMapsetPos - 1);
+    if (nLocationPos == std::string::npos || nLocationPos == 0)
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed,
+                 "GRASS: Expected GRASS:<gisdbase>/<location>/<mapset>, "
+                 "got %s",
+                 poOpenInfo->pszFilename);
+        return nullptr;
+    }
+    const std::string osMapset = osMapsetDir.substr(nMapsetPos + 1);
 
-    if (nGRSType == CELL_TYPE &&
-        (!nativeNulls || eBufType != GDT_Int32 || sizeof(CELL) != 4 ||
-         nPixelSpace != sizeof(CELL)))
+    VSIStatBufL sStat;
+    if (VSIStatL(osMapsetDir.c_str(), &sStat) != 0 ||
+        !VSI_ISDIR(sStat.st_mode))
     {
-        cbuf = Rast_allocate_c_buf();
+        CPLError(CE_Failure, CPLE_OpenFailed, "GRASS: Cannot find mapset %s",
+                 osMapsetDir.c_str());
+        return nullptr;
     }
-    else if (nGRSType == FCELL_TYPE &&
-             (eBufType != GDT_Float32 || nPixelSpace != sizeof(FCELL)))
+
+    if (poOpenInfo->eAccess == GA_Update)
     {
-        fbuf = Rast_allocate_f_buf();
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "The GRASS driver does not support update access to existing"
+                 " datasets.\n");
+        return nullptr;
     }
-    else if (nGRSType == DCELL_TYPE &&
-             (eBufType != GDT_Float64 || nPixelSpace != sizeof(DCELL)))
+
+    const GRASSMapsetListing oListing = GetMapsetListing(osMapsetDir);
+
+    CPLStringList aosSubdatasets;
+    int iSubdataset = 1;
+    for (const std::string &osName : oListing.aosCells)
     {
-        dbuf = Rast_allocate_d_buf();
+        const std::string osPath = osMapsetDir + "/cellhd/" + osName;
+        aosSubdatasets.SetNameValue(
+            CPLSPrintf("SUBDATASET_%d_NAME", iSubdataset), osPath.c_str());
+        const std::string osDesc =
+            "Raster map " + osName + "@" + osMapset;
+        aosSubdatasets.SetNameValue(
+            CPLSPrintf("SUBDATASET_%d_DESC", iSubdataset), osDesc.c_str());
+        iSubdataset++;
     }
-    else
+    for (const std::string &osName : oListing.aosGroups)
     {
-        direct = true;
+        const std::string osPath = osMapsetDir + "/group/" + osName;
+        aosSubdatasets.SetNameValue(
+            CPLSPrintf("SUBDATASET_%d_NAME", iSubdataset), osPath.c_str());
+        const std::string osDesc =
+            "Imagery group " + osName + "@" + osMapset;
+        aosSubdatasets.SetNameValue(
+            CPLSPrintf("SUBDATASET_%d_DESC", iSubdataset), osDesc.c_str());
+        iSubdataset++;
     }
 
-    for (int row = 0; row < nBufYSize; row++)
-    {
-        char *pnt = static_cast<char *>(pData) + row * nLineSpace;
+    auto poDS = new GRASSMapsetDataset();
+    poDS->eAccess = poOpenInfo->eAccess;
+    poDS->SetDescription(poOpenInfo->pszFilename);
+    poDS->SetMetadata(aosSubdatasets.List(), "SUBDATASETS");
 
-        if (nGRSType == CELL_TYPE)
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
+    if ((poOpenInfo->nOpenFlags & GDAL_OF_MULTIDIM_RASTER) != 0)
+    {
         {
-            if (direct)
+            auto oLock = GRASSSession::Acquire();
+            if (!InitGRASSLibraries())
             {
-                Rast_get_c_row(hCell, reinterpret_cast<CELL *>(pnt), row);
+                delete poDS;
+                return nullptr;
             }
-            else
-            {
-                Rast_get_c_row(hCell, cbuf, row);
+        }
+        poDS->poRootGroup = std::make_shared<GRASSMapsetGroup>(
+            osMapsetDir.substr(0, nLocationPos),
+            osMapsetDir.substr(nLocationPos + 1,
+                               nMapsetPos - nLocationPos - 1),
+            osMapset,
+            CPLFetchBool(poOpenInfo->papszOpenOptions, "NATIVE_DECODER",
+                         false));
+    }
+#endif
 
-                /* Reset nullptrs */
-                for (int col = 0; col < nBufXSize; col++)
-                {
-                    if (Rast_is_c_null_value(&(cbuf[col])))
-                        cbuf[col] = (CELL)dfNoData;
-                }
+    return poDS;
+}
 
-                GDALCopyWords(static_cast<void *>(cbuf), GDT_Int32,
-                              sizeof(CELL), static_cast<void *>(pnt), eBufType,
-                              (int)nPixelSpace, nBufXSize);
-            }
-        }
-        else if (nGRSType == FCELL_TYPE)
-        {
-            if (direct)
-            {
-                Rast_get_f_row(hCell, reinterpret_cast<FCELL *>(pnt), row);
-            }
-            else
-            {
-                Rast_get_f_row(hCell, fbuf, row);
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
 
-                GDALCopyWords(static_cast<void *>(fbuf), GDT_Float32,
-                              sizeof(FCELL), static_cast<void *>(pnt), eBufType,
-                              (int)nPixelSpace, nBufXSize);
-            }
-        }
-        else if (nGRSType == DCELL_TYPE)
+/************************************************************************/
+/*                           GetRootGroup()                             */
+/************************************************************************/
+
+auto GRASSMapsetDataset::GetRootGroup() const -> std::shared_ptr<GDALGroup>
+{
+    return poRootGroup;
+}
+
+/************************************************************************/
+/*                        GetTemporalDatabase()                         */
+/*                                                                      */
+/* SQLite temporal database of a mapset, as found by the tgis library: */
+/* TGISDB_DATABASE of the VAR file of the mapset, tgis/sqlite.db of the */
+/* PERMANENT mapset by default. Empty if the mapset uses another        */
+/* database driver.                                                     */
+/************************************************************************/
+
+static auto GetTemporalDatabase(const std::string &osGisdbase,
+                                const std::string &osLocation,
+                                const std::string &osMapset) -> std::string
+{
+    std::string osDriver = "sqlite";
+    std::string osDatabase =
+        osGisdbase + "/" + osLocation + "/PERMANENT/tgis/sqlite.db";
+
+    VSIStatBufL sStat;
+    const std::string osVarFile =
+        osGisdbase + "/" + osLocation + "/" + osMapset + "/VAR";
+    if (VSIStatL(osVarFile.c_str(), &sStat) == 0)
+    {
+        const CPLStringList aosVars(
+            CSLLoad2(osVarFile.c_str(), -1, -1, nullptr));
+        for (int i = 0; i < aosVars.size(); i++)
         {
-            if (direct)
-            {
-                Rast_get_d_row(hCell, reinterpret_cast<DCELL *>(pnt), row);
-            }
-            else
+            char *pszKey = nullptr;
+            const char *pszValue = CPLParseNameValue(aosVars[i], &pszKey);
+            if (pszKey != nullptr && pszValue != nullptr)
             {
-                Rast_get_d_row(hCell, dbuf, row);
-
-                GDALCopyWords(static_cast<void *>(dbuf), GDT_Float64,
-                              sizeof(DCELL), static_cast<void *>(pnt), eBufType,
-                              (int)nPixelSpace, nBufXSize);
+                if (EQUAL(pszKey, "TGISDB_DRIVER"))
+                    osDriver = pszValue;
+                else if (EQUAL(pszKey, "TGISDB_DATABASE"))
+                    osDatabase = pszValue;
             }
+            CPLFree(pszKey);
         }
     }
 
-    if (cbuf)
-        G_free(cbuf);
-    if (fbuf)
-        G_free(fbuf);
-    if (dbuf)
-        G_free(dbuf);
+    if (!EQUAL(osDriver.c_str(), "sqlite"))
+    {
+        CPLDebug("GRASS", "Temporal database driver %s not supported",
+                 osDriver.c_str());
+        return std::string();
+    }
 
-    // close to avoid confusion with other GRASS raster bands
-    Rast_close(hCell);
-    hCell = -1;
+    const std::pair<const char *, const std::string *> asVariables[] = {
+        {"$GISDBASE", &osGisdbase},
+        {"$LOCATION_NAME", &osLocation},
+        {"$MAPSET", &osMapset}};
+    for (const auto &oVariable : asVariables)
+    {
+        size_t nPos = 0;
+        while ((nPos = osDatabase.find(oVariable.first, nPos)) !=
+               std::string::npos)
+        {
+            osDatabase.replace(nPos, strlen(oVariable.first),
+                               *oVariable.second);
+            nPos += oVariable.second->size();
+        }
+    }
 
-    return CE_None;
+    return osDatabase;
 }
 
 /************************************************************************/
-/*                       GetColorInterpretation()                       */
+/*                         QueryTemporalDB()                            */
+/*                                                                      */
+/* Rows of the first nFields fields of a query, null fields as empty    */
+/* strings.                                                             */
 /************************************************************************/
 
-auto GRASSRasterBand::GetColorInterpretation() -> GDALColorInterp
+static auto QueryTemporalDB(GDALDataset *poDB, const std::string &osSQL,
+                            int nFields)
+    -> std::vector<std::vector<std::string>>
 {
-    if (poCT != nullptr)
-        return GCI_PaletteIndex;
-    else
-        return GCI_GrayIndex;
+    std::vector<std::vector<std::string>> aaosRows;
+
+    OGRLayer *poLayer = poDB->ExecuteSQL(osSQL.c_str(), nullptr, nullptr);
+    if (poLayer == nullptr)
+        return aaosRows;
+
+    while (true)
+    {
+        OGRFeatureUniquePtr poFeature(poLayer->GetNextFeature());
+        if (!poFeature)
+            break;
+        std::vector<std::string> aosRow;
+        for (int iField = 0; iField < nFields; iField++)
+            aosRow.push_back(poFeature->IsFieldSetAndNotNull(iField)
+                                 ? poFeature->GetFieldAsString(iField)
+                                 : "");
+        aaosRows.push_back(aosRow);
+    }
+    poDB->ReleaseResultSet(poLayer);
+
+    return aaosRows;
 }
 
 /************************************************************************/
-/*                           GetColorTable()                            */
+/*                              SQLQuote()                              */
 /************************************************************************/
 
-auto GRASSRasterBand::GetColorTable() -> GDALColorTable *
+static auto SQLQuote(const std::string &osValue) -> std::string
 {
-    return poCT;
+    std::string osQuoted = "'";
+    for (const char ch : osValue)
+    {
+        osQuoted += ch;
+        if (ch == '\'')
+            osQuoted += ch;
+    }
+    return osQuoted + "'";
 }
 
 /************************************************************************/
-/*                             GetMinimum()                             */
+/*                             ReadSTRDS()                              */
+/*                                                                      */
+/* Read the maps registered in a STRDS, ordered by start time, and its  */
+/* data type: the type of its maps, DCELL if they differ.               */
 /************************************************************************/
 
-auto GRASSRasterBand::GetMinimum(int *pbSuccess) -> double
+static auto ReadSTRDS(GDALDataset *poDB, const std::string &osId,
+                      GRASSSTRDSInfo &sInfo) -> bool
 {
-    if (pbSuccess)
-        *pbSuccess = bHaveMinMax;
+    const auto aaosSTRDS = QueryTemporalDB(
+        poDB,
+        "SELECT s.temporal_type, m.raster_register FROM strds AS s "
+        "JOIN strds_metadata AS m ON m.id = s.id WHERE s.id = " +
+            SQLQuote(osId),
+        2);
+    if (aaosSTRDS.empty())
+        return false;
 
-    if (bHaveMinMax)
-        return dfCellMin;
+    // the register is a table name
+    const std::string &osRegister = aaosSTRDS[0][1];
+    if (osRegister.empty() ||
+        osRegister.find_first_not_of("abcdefghijklmnopqrstuvwxyz"
+                                     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                     "0123456789_") != std::string::npos)
+    {
+        CPLDebug("GRASS", "No maps registered in %s", osId.c_str());
+        return false;
+    }
 
-    else if (eDataType == GDT_Float32 || eDataType == GDT_Float64)
-        return -4294967295.0;
-    else
-        return 0;
+    sInfo.bAbsolute = aaosSTRDS[0][0] != "relative";
+    std::string osTimes = "raster_absolute_time";
+    std::string osStart = "strftime('%s', t.start_time)";
+    if (!sInfo.bAbsolute)
+    {
+        const auto aaosUnit = QueryTemporalDB(
+            poDB,
+            "SELECT unit FROM strds_relative_time WHERE id = " +
+                SQLQuote(osId),
+            1);
+        sInfo.osUnit = aaosUnit.empty() ? "" : aaosUnit[0][0];
+        osTimes = "raster_relative_time";
+        osStart = "t.start_time";
+    }
+
+    const auto aaosMaps = QueryTemporalDB(
+        poDB,
+        "SELECT b.name, b.mapset, " + osStart +
+            ", m.datatype FROM " + osRegister +
+            " AS r JOIN raster_base AS b ON b.id = r.id JOIN " + osTimes +
+            " AS t ON t.id = r.id JOIN raster_metadata AS m ON m.id = r.id "
+            "ORDER BY t.start_time",
+        4);
+    if (aaosMaps.empty())
+        return false;
+
+    for (size_t i = 0; i < aaosMaps.size(); i++)
+    {
+        const std::vector<std::string> &aosMap = aaosMaps[i];
+        sInfo.asMaps.push_back(
+            {aosMap[0], aosMap[1], CPLAtof(aosMap[2].c_str())});
+
+        const GDALDataType eMapType =
+            aosMap[3] == "DCELL"   ? GDT_Float64
+            : aosMap[3] == "FCELL" ? GDT_Float32
+                                   : GDT_Int32;
+        if (i == 0)
+            sInfo.eType = eMapType;
+        else if (eMapType != sInfo.eType)
+            sInfo.eType = GDT_Float64;
+    }
+
+    return true;
 }
 
 /************************************************************************/
-/*                             GetMaximum()                             */
+/*                          GRASSMapsetGroup()                          */
 /************************************************************************/
 
-auto GRASSRasterBand::GetMaximum(int *pbSuccess) -> double
+GRASSMapsetGroup::GRASSMapsetGroup(const std::string &osGisdbaseIn,
+                                   const std::string &osLocationIn,
+                                   const std::string &osMapsetIn,
+                                   bool bNativeDecoderIn)
+    : GDALGroup(std::string(), "/"), osGisdbase(osGisdbaseIn),
+      osLocation(osLocationIn), osMapset(osMapsetIn),
+      bNativeDecoder(bNativeDecoderIn)
 {
-    if (pbSuccess)
-        *pbSuccess = bHaveMinMax;
+    const std::string osDatabase =
+        GetTemporalDatabase(osGisdbase, osLocation, osMapset);
+    VSIStatBufL sStat;
+    if (osDatabase.empty() || VSIStatL(osDatabase.c_str(), &sStat) != 0)
+    {
+        CPLDebug("GRASS", "No temporal database for mapset %s",
+                 osMapset.c_str());
+        return;
+    }
 
-    if (bHaveMinMax)
-        return dfCellMax;
+    const char *const apszDrivers[] = {"SQLite", nullptr};
+    poTemporalDB.reset(GDALDataset::Open(osDatabase.c_str(),
+                                         GDAL_OF_VECTOR | GDAL_OF_READONLY,
+                                         apszDrivers));
+    if (!poTemporalDB)
+        return;
 
-    else if (eDataType == GDT_Float32 || eDataType == GDT_Float64 ||
-             eDataType == GDT_UInt32)
-        return 4294967295.0;
-    else if (eDataType == GDT_UInt16)
-        return 65535;
-    else
-        return 255;
+    for (const auto &aosRow : QueryTemporalDB(
+             poTemporalDB.get(),
+             "SELECT name FROM strds WHERE mapset = " + SQLQuote(osMapset) +
+                 " ORDER BY name",
+             1))
+        aosSTRDS.push_back(aosRow[0]);
 }
 
 /************************************************************************/
-/*                           GetNoDataValue()                           */
+/*                          GetMDArrayNames()                           */
 /************************************************************************/
 
-auto GRASSRasterBand::GetNoDataValue(int *pbSuccess) -> double
+auto GRASSMapsetGroup::GetMDArrayNames(CSLConstList) const
+    -> std::vector<std::string>
 {
-    if (pbSuccess)
-        *pbSuccess = TRUE;
+    return aosSTRDS;
+}
+
+/************************************************************************/
+/*                            OpenMDArray()                             */
+/************************************************************************/
+
+auto GRASSMapsetGroup::OpenMDArray(const std::string &osName,
+                                   CSLConstList) const
+    -> std::shared_ptr<GDALMDArray>
+{
+    const auto oIter = oArrays.find(osName);
+    if (oIter != oArrays.end())
+        return oIter->second;
+
+    if (std::find(aosSTRDS.begin(), aosSTRDS.end(), osName) ==
+        aosSTRDS.end())
+        return nullptr;
+
+    GRASSSTRDSInfo sInfo;
+    sInfo.osName = osName;
+    if (!ReadSTRDS(poTemporalDB.get(), osName + "@" + osMapset, sInfo))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "GRASS: Cannot read the maps of space time raster dataset "
+                 "%s@%s",
+                 osName.c_str(), osMapset.c_str());
+        return nullptr;
+    }
 
-    return dfNoData;
+    auto poArray = GRASSSTRDSArray::Create(
+        GetFullName(),
+        "GRASS:" + osGisdbase + "/" + osLocation + "/" + osMapset,
+        osGisdbase, osLocation, bNativeDecoder, std::move(sInfo));
+    if (poArray)
+        oArrays[osName] = poArray;
+    return poArray;
 }
 
 /************************************************************************/
-/* ==================================================================== */
-/*                             GRASSDataset                             */
-/* ==================================================================== */
+/*                          GRASSTimeArray()                            */
 /************************************************************************/
 
+GRASSTimeArray::GRASSTimeArray(const std::string &osParentName,
+                               const std::string &osFilenameIn,
+                               const std::shared_ptr<GDALDimension> &poDim,
+                               std::vector<double> &&adfTimesIn,
+                               bool bAbsolute, const std::string &osUnitIn)
+    : GDALAbstractMDArray(osParentName, poDim->GetName()),
+      GDALMDArray(osParentName, poDim->GetName()), osFilename(osFilenameIn),
+      adfTimes(std::move(adfTimesIn)),
+      osUnit(bAbsolute ? "seconds since 1970-01-01 00:00:00" : osUnitIn),
+      apoDims{poDim}
+{
+    apoAttributes.push_back(
+        std::make_shared<GDALAttributeString>(GetFullName(), "units", osUnit));
+    if (bAbsolute)
+        apoAttributes.push_back(std::make_shared<GDALAttributeString>(
+            GetFullName(), "calendar", "standard"));
+}
+
 /************************************************************************/
-/*                            GRASSDataset()                            */
+/*                       GRASSTimeArray::IRead()                        */
 /************************************************************************/
 
-GRASSDataset::GRASSDataset(GRASSRasterPath &gpath)
-    : osGisdbase(gpath.gisdbase), osLocation(gpath.location),
-      osElement(gpath.element)
+auto GRASSTimeArray::IRead(const GUInt64 *arrayStartIdx, const size_t *count,
+                           const GInt64 *arrayStep,
+                           const GPtrDiff_t *bufferStride,
+                           const GDALExtendedDataType &bufferDataType,
+                           void *pDstBuffer) const -> bool
 {
-    m_oSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+    const size_t nDTSize = bufferDataType.GetSize();
+    for (size_t i = 0; i < count[0]; i++)
+    {
+        const size_t iTime = static_cast<size_t>(
+            static_cast<GInt64>(arrayStartIdx[0]) +
+            static_cast<GInt64>(i) * arrayStep[0]);
+        void *pDst = static_cast<GByte *>(pDstBuffer) +
+                     static_cast<GPtrDiff_t>(i) * bufferStride[0] *
+                         static_cast<GPtrDiff_t>(nDTSize);
+        if (!GDALExtendedDataType::CopyValue(&adfTimes[iTime], oType, pDst,
+                                             bufferDataType))
+            return false;
+    }
+    return true;
 }
 
 /************************************************************************/
-/*                          GetSpatialRef()                             */
+/*                          GRASSSTRDSArray()                           */
 /************************************************************************/
 
-auto GRASSDataset::GetSpatialRef() const -> const OGRSpatialReference *
+GRASSSTRDSArray::GRASSSTRDSArray(const std::string &osParentName,
+                                 const std::string &osFilenameIn,
+                                 GRASSSTRDSInfo &&sInfoIn,
+                                 std::unique_ptr<GRASSDataset> poGridDSIn)
+    : GDALAbstractMDArray(osParentName, sInfoIn.osName),
+      GDALMDArray(osParentName, sInfoIn.osName), osFilename(osFilenameIn),
+      sInfo(std::move(sInfoIn)),
+      oType(GDALExtendedDataType::Create(sInfo.eType)),
+      dfNoData(sInfo.eType == GDT_Int32
+                   ? static_cast<double>(std::numeric_limits<CELL>::min())
+                   : std::numeric_limits<double>::quiet_NaN()),
+      poGridDS(std::move(poGridDSIn)), apoSlices(sInfo.asMaps.size())
 {
-    return m_oSRS.IsEmpty() ? nullptr : &m_oSRS;
+    abyNoData.resize(GDALGetDataTypeSizeBytes(sInfo.eType));
+    GDALCopyWords(&dfNoData, GDT_Float64, 0, abyNoData.data(), sInfo.eType, 0,
+                  1);
+
+    const struct Cell_head &sWindow = poGridDS->sCellInfo;
+    const std::string osDimParent = GetFullName();
+
+    auto poTimeDim = std::make_shared<GDALDimensionWeakIndexingVar>(
+        osDimParent, "time", GDAL_DIM_TYPE_TEMPORAL, std::string(),
+        sInfo.asMaps.size());
+    auto poYDim = std::make_shared<GDALDimensionWeakIndexingVar>(
+        osDimParent, "y", GDAL_DIM_TYPE_HORIZONTAL_Y, "NORTH",
+        sWindow.rows);
+    auto poXDim = std::make_shared<GDALDimensionWeakIndexingVar>(
+        osDimParent, "x", GDAL_DIM_TYPE_HORIZONTAL_X, "EAST", sWindow.cols);
+    apoDims = {poTimeDim, poYDim, poXDim};
+
+    std::vector<double> adfTimes;
+    for (const auto &sMap : sInfo.asMaps)
+        adfTimes.push_back(sMap.dfTime);
+    auto poTimeVar = std::make_shared<GRASSTimeArray>(
+        osDimParent, osFilename, poTimeDim, std::move(adfTimes),
+        sInfo.bAbsolute, sInfo.osUnit);
+    // cell centers
+    auto poYVar = GDALMDArrayRegularlySpaced::Create(
+        osDimParent, "y", poYDim, sWindow.north, -sWindow.ns_res, 0.5);
+    auto poXVar = GDALMDArrayRegularlySpaced::Create(
+        osDimParent, "x", poXDim, sWindow.west, sWindow.ew_res, 0.5);
+    apoIndexingVars = {poTimeVar, poYVar, poXVar};
+    poTimeDim->SetIndexingVariable(poTimeVar);
+    poYDim->SetIndexingVariable(poYVar);
+    poXDim->SetIndexingVariable(poXVar);
+
+    if (poGridDS->m_poSRS != nullptr)
+    {
+        // SRS axes to the x and y dimensions, as GDAL does for bands
+        poSRS.reset(poGridDS->m_poSRS->Clone());
+        std::vector<int> anMapping = poSRS->GetDataAxisToSRSAxisMapping();
+        for (int &nAxis : anMapping)
+            nAxis = nAxis == 1 ? 3 : nAxis == 2 ? 2 : 0;
+        poSRS->SetDataAxisToSRSAxisMapping(anMapping);
+    }
 }
 
 /************************************************************************/
-/*                          GetGeoTransform()                           */
+/*                      GRASSSTRDSArray::Create()                       */
+/*                                                                      */
+/* The region of the array is the region of the first map, the other   */
+/* maps are read in it.                                                 */
 /************************************************************************/
 
-
-#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 12, 0)
-auto GRASSDataset::GetGeoTransform(GDALGeoTransform &gt) const -> CPLErr
+auto GRASSSTRDSArray::Create(const std::string &osParentName,
+                             const std::string &osFilename,
+                             const std::string &osGisdbase,
+                             const std::string &osLocation,
+                             bool bNativeDecoder, GRASSSTRDSInfo &&sInfo)
+    -> std::shared_ptr<GRASSSTRDSArray>
 {
-    gt = m_gt;
+    const GRASSSTRDSInfo::Map &sFirst = sInfo.asMaps[0];
+    const std::string osFirstPath = osGisdbase + "/" + osLocation + "/" +
+                                    sFirst.osMapset + "/cellhd/" +
+                                    sFirst.osName;
+    GRASSRasterPath gp(osFirstPath.c_str());
+    if (!gp.isValid())
+        return nullptr;
 
-    return CE_None;
-}
-#else
-auto GRASSDataset::GetGeoTransform(double *padfGeoTransform) -> CPLErr
-{
-    memcpy(padfGeoTransform, m_gt.data(), sizeof(double) * 6);
+    std::unique_ptr<GRASSDataset> poGridDS(new GRASSDataset(gp));
+    poGridDS->bNativeDecoder = bNativeDecoder;
+    {
+        auto oLock = GRASSSession::Acquire();
+        GRASSSession::SetEnv(osGisdbase, osLocation, sFirst.osMapset);
+        if (G_find_file2("cellhd", sFirst.osName.c_str(),
+                         sFirst.osMapset.c_str()) == nullptr)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "GRASS: Cannot find raster map %s@%s of space time "
+                     "raster dataset %s",
+                     sFirst.osName.c_str(), sFirst.osMapset.c_str(),
+                     sInfo.osName.c_str());
+            return nullptr;
+        }
+        Rast_get_cellhd(sFirst.osName.c_str(), sFirst.osMapset.c_str(),
+                        &(poGridDS->sCellInfo));
+        poGridDS->m_poSRS = GRASSSession::GetSpatialRef();
+    }
+    poGridDS->nRasterXSize = poGridDS->sCellInfo.cols;
+    poGridDS->nRasterYSize = poGridDS->sCellInfo.rows;
 
-    return CE_None;
+    auto poArray = std::shared_ptr<GRASSSTRDSArray>(new GRASSSTRDSArray(
+        osParentName, osFilename, std::move(sInfo), std::move(poGridDS)));
+    poArray->SetSelf(poArray);
+    return poArray;
 }
-#endif
 
 /************************************************************************/
-/*                                Open()                                */
+/*                              GetSlice()                              */
+/*                                                                      */
+/* Band of the map at a time index, set up on first use. The band read  */
+/* the longest ago is closed, with its raster and decoder files, when   */
+/* more than GRASS_MAX_OPEN_RASTERS bands would be open.                */
 /************************************************************************/
 
-using GrassErrorHandler = auto(*)(const char *, int) -> int;
-
-auto GRASSDataset::Open(GDALOpenInfo *poOpenInfo) -> GDALDataset *
+auto GRASSSTRDSArray::GetSlice(size_t iSlice) const -> GRASSRasterBand *
 {
-    char **papszCells = nullptr;
-    char **papszMapsets = nullptr;
+    std::unique_ptr<GRASSRasterBand> &poSlice = apoSlices[iSlice];
+    if (poSlice)
+    {
+        if (anOpenSlices.front() != iSlice)
+        {
+            anOpenSlices.remove(iSlice);
+            anOpenSlices.push_front(iSlice);
+        }
+        return poSlice.get();
+    }
 
-    /* -------------------------------------------------------------------- */
-    /*      Does this even look like a grass file path?                     */
-    /* -------------------------------------------------------------------- */
-    if (strstr(poOpenInfo->pszFilename, "/cellhd/") == nullptr &&
-        strstr(poOpenInfo->pszFilename, "/group/") == nullptr)
+    const size_t nMaxOpen = static_cast<size_t>(GetMaxOpenRasters());
+    while (anOpenSlices.size() >= nMaxOpen)
+    {
+        apoSlices[anOpenSlices.back()].reset();
+        anOpenSlices.pop_back();
+    }
+
+    const GRASSSTRDSInfo::Map &sMap = sInfo.asMaps[iSlice];
+    auto oLock = GRASSSession::Acquire();
+    GRASSSession::SetEnv(poGridDS->osGisdbase, poGridDS->osLocation,
+                         sMap.osMapset);
+    if (G_find_file2("cell", sMap.osName.c_str(), sMap.osMapset.c_str()) ==
+        nullptr)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "GRASS: Cannot find raster map %s@%s of space time raster "
+                 "dataset %s",
+                 sMap.osName.c_str(), sMap.osMapset.c_str(),
+                 sInfo.osName.c_str());
         return nullptr;
+    }
+
+    GRASSBandInfo sBandInfo;
+    GRASSRasterBand::ReadInfo(sMap.osMapset, sMap.osName,
+                              &(poGridDS->sCellInfo), &sBandInfo);
+    poSlice.reset(new GRASSRasterBand(poGridDS.get(),
+                                      static_cast<int>(iSlice) + 1,
+                                      sMap.osMapset, sMap.osName, sBandInfo));
+    poSlice->PrepareReading();
+    anOpenSlices.push_front(iSlice);
 
-    /* Always init, if no rasters are opened G_no_gisinit resets the projection and
-     * rasters in different projection may be then opened */
+    return poSlice.get();
+}
 
-    // Don't use GISRC file and read/write GRASS variables (from location G_VAR_GISRC) to memory only.
-    G_set_gisrc_mode(G_GISRC_MODE_MEMORY);
+/************************************************************************/
+/*                       GRASSSTRDSArray::IRead()                       */
+/*                                                                      */
+/* Rows are read whole in the region of the array, only the requested   */
+/* rows of each map are decoded. A time series at a cell decodes one    */
+/* row per map, shared through the row cache with the reads of the      */
+/* neighbouring cells.                                                  */
+/************************************************************************/
 
-    // Init GRASS libraries (required)
-    G_no_gisinit();  // Doesn't check write permissions for mapset compare to G_gisinit
+auto GRASSSTRDSArray::IRead(const GUInt64 *arrayStartIdx, const size_t *count,
+                            const GInt64 *arrayStep,
+                            const GPtrDiff_t *bufferStride,
+                            const GDALExtendedDataType &bufferDataType,
+                            void *pDstBuffer) const -> bool
+{
+    if (bufferDataType.GetClass() != GEDTC_NUMERIC)
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "GRASS: Only numeric buffer data types are supported");
+        return false;
+    }
+    const GDALDataType eBufType = bufferDataType.GetNumericDataType();
+    const GPtrDiff_t nBufTypeSize = GDALGetDataTypeSizeBytes(eBufType);
+    const int nCols = static_cast<int>(count[2]);
 
-    // Set error function
-    G_set_error_routine(GrassErrorHandler(Grass2CPLErrorHook));
+    struct Cell_head sWindow = poGridDS->sCellInfo;
+    std::vector<GByte> abyRow(static_cast<size_t>(sWindow.cols) *
+                              sizeof(DCELL));
+    std::vector<GByte> abyCells(static_cast<size_t>(nCols) * sizeof(DCELL));
 
-    // GISBASE is path to the directory where GRASS is installed,
-    if (!getenv("GISBASE"))
+    for (size_t iTime = 0; iTime < count[0]; iTime++)
     {
-        static char *gisbaseEnv = nullptr;
-        const char *gisbase = GRASS_GISBASE;
-        CPLError(CE_Warning, CPLE_AppDefined,
-                 "GRASS warning: GISBASE "
-                 "environment variable was not set, using:\n%s",
-                 gisbase);
-        std::array<char, BUFF_SIZE> buf{};
-        int res = std::snprintf(buf.data(), BUFF_SIZE, "GISBASE=%s", gisbase);
-        if (res >= BUFF_SIZE)
+        const size_t iSlice =
+            static_cast<size_t>(static_cast<GInt64>(arrayStartIdx[0]) +
+                                static_cast<GInt64>(iTime) * arrayStep[0]);
+        GRASSRasterBand *poSlice = GetSlice(iSlice);
+        if (poSlice == nullptr)
+            return false;
+
+        // the GRASS libraries are not thread safe, the decoder is
+        GRASSSession::Lock oLock;
+        if (!poSlice->bNativeRows)
+            oLock = GRASSSession::Acquire();
+        if (poSlice->BeginRead(&sWindow) != CE_None)
+            return false;
+
+        const GDALDataType eRowType = GRASSRowDataType(poSlice->nGRSType);
+        const int nRowTypeSize = GDALGetDataTypeSizeBytes(eRowType);
+
+        for (size_t iY = 0; iY < count[1]; iY++)
         {
-            CPLError(
-                CE_Warning, CPLE_AppDefined,
-                "GRASS warning: GISBASE environment variable was too long.\n");
-            return nullptr;
-        }
+            const int nRow =
+                static_cast<int>(static_cast<GInt64>(arrayStartIdx[1]) +
+                                 static_cast<GInt64>(iY) * arrayStep[1]);
+            if (poSlice->ReadGRASSRow(&sWindow, nRow, abyRow.data()) !=
+                CE_None)
+                return false;
+
+            GByte *pabyCells = abyRow.data() +
+                               static_cast<size_t>(arrayStartIdx[2]) *
+                                   nRowTypeSize;
+            if (arrayStep[2] != 1)
+            {
+                GDALCopyWords64(pabyCells, eRowType,
+                                static_cast<int>(arrayStep[2] * nRowTypeSize),
+                                abyCells.data(), eRowType, nRowTypeSize,
+                                nCols);
+                pabyCells = abyCells.data();
+            }
 
-        CPLFree(gisbaseEnv);
-        gisbaseEnv = CPLStrdup(buf.data());
-        putenv(gisbaseEnv);
+            GByte *pabyDst = static_cast<GByte *>(pDstBuffer) +
+                             (static_cast<GPtrDiff_t>(iTime) * bufferStride[0] +
+                              static_cast<GPtrDiff_t>(iY) * bufferStride[1]) *
+                                 nBufTypeSize;
+            GRASSCopyRow(pabyCells, poSlice->nGRSType, pabyDst, eBufType,
+                         static_cast<int>(bufferStride[2] * nBufTypeSize),
+                         nCols, dfNoData);
+        }
     }
 
-    GRASSRasterPath gp = GRASSRasterPath(poOpenInfo->pszFilename);
+    return true;
+}
 
-    /* -------------------------------------------------------------------- */
-    /*      Check element name                                              */
-    /* -------------------------------------------------------------------- */
-    if (!gp.isValid())
+#endif /* GDAL_VERSION_NUM >= 3.8 */
+
+/************************************************************************/
+/*                          GRASSAsyncReader()                          */
+/************************************************************************/
+
+GRASSAsyncReader::GRASSAsyncReader(
+    GRASSDataset *poDSIn, const std::vector<GRASSRasterBand *> &apoBandsIn,
+    bool bCoarseToFineIn, int nXOffIn, int nYOffIn, int nXSizeIn,
+    int nYSizeIn, void *pBufIn, int nBufXSizeIn, int nBufYSizeIn,
+    GDALDataType eBufTypeIn, int nPixelSpaceIn, int nLineSpaceIn,
+    int nBandSpaceIn)
+    : apoBands(apoBandsIn), bCoarseToFine(bCoarseToFineIn)
+{
+    poDS = poDSIn;
+    nXOff = nXOffIn;
+    nYOff = nYOffIn;
+    nXSize = nXSizeIn;
+    nYSize = nYSizeIn;
+    pBuf = pBufIn;
+    nBufXSize = nBufXSizeIn;
+    nBufYSize = nBufYSizeIn;
+    eBufType = eBufTypeIn;
+    nBandCount = static_cast<int>(apoBands.size());
+    panBandMap = static_cast<int *>(CPLMalloc(sizeof(int) * nBandCount));
+    for (int i = 0; i < nBandCount; i++)
+        panBandMap[i] = apoBands[i]->GetBand();
+    nPixelSpace = nPixelSpaceIn;
+    nLineSpace = nLineSpaceIn;
+    nBandSpace = nBandSpaceIn;
+
+    for (auto poBand : apoBands)
+        bAllNative = bAllNative && poBand->bNativeRows;
+
+    GetReadWindow(&(poDSIn->sCellInfo), nXOff, nYOff, nXSize, nYSize,
+                  nBufXSize, nBufYSize, &sWindow);
+}
+
+/************************************************************************/
+/*                         ~GRASSAsyncReader()                          */
+/************************************************************************/
+
+GRASSAsyncReader::~GRASSAsyncReader()
+{
     {
-        return nullptr;
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bStop = true;
     }
+    if (oThread.joinable())
+        oThread.join();
+    CPLFree(panBandMap);
+}
 
-    /* -------------------------------------------------------------------- */
-    /*      Set GRASS variables                                             */
-    /* -------------------------------------------------------------------- */
+/************************************************************************/
+/*                               Start()                                */
+/************************************************************************/
 
-    G_setenv_nogisrc("GISDBASE", gp.gisdbase.c_str());
-    G_setenv_nogisrc("LOCATION_NAME", gp.location.c_str());
-    G_setenv_nogisrc(
-        "MAPSET",
-        gp.mapset.c_str());  // group is searched only in current mapset
-    G_reset_mapsets();
-    G_add_mapset_to_search_path(gp.mapset.c_str());
+void GRASSAsyncReader::Start()
+{
+    oThread = std::thread([this]() { Run(); });
+}
 
-    /* -------------------------------------------------------------------- */
-    /*      Check if this is a valid grass cell.                            */
-    /* -------------------------------------------------------------------- */
-    if (gp.isCellHD())
-    {
+/************************************************************************/
+/*                                Run()                                 */
+/*                                                                      */
+/* With ROW_ORDER=COARSE_TO_FINE every COARSE_STEP-th row is read first */
+/* and copied over the rows below it, then the rows in between with     */
+/* halving steps, so that the buffer always holds a preview of the      */
+/* whole window.                                                        */
+/************************************************************************/
 
-        if (G_find_file2("cell", gp.name.c_str(), gp.mapset.c_str()) == nullptr)
-        {
-            return nullptr;
-        }
+void GRASSAsyncReader::Run()
+{
+    std::vector<std::vector<GByte>> aabyRows(
+        apoBands.size(),
+        std::vector<GByte>(static_cast<size_t>(nBufXSize) * sizeof(DCELL)));
 
-        papszMapsets = CSLAddString(papszMapsets, gp.mapset.c_str());
-        papszCells = CSLAddString(papszCells, gp.name.c_str());
-    }
+    int nFirstStep = 1;
+    while (bCoarseToFine && nFirstStep < COARSE_STEP &&
+           nFirstStep * 2 < nBufYSize)
+        nFirstStep *= 2;
 
-    /* -------------------------------------------------------------------- */
-    /*      Check if this is a valid GRASS imagery group.                   */
-    /* -------------------------------------------------------------------- */
-    else
+    bool bOK = true;
+    for (int nStep = nFirstStep; nStep >= 1 && bOK; nStep /= 2)
     {
-        struct Ref ref
-        {
-        };
+        // rows of the coarser steps are already read
+        const int nStartRow = nStep == nFirstStep ? 0 : nStep;
+        const int nRowStep = nStep == nFirstStep ? nStep : 2 * nStep;
 
-        I_init_group_ref(&ref);
-        bool has_group_ref = I_get_group_ref(gp.name.c_str(), &ref);
-        if (!has_group_ref || ref.nfiles <= 0)
+        for (int iRow = nStartRow; iRow < nBufYSize && bOK; iRow += nRowStep)
         {
-            return nullptr;
-        }
+            {
+                std::lock_guard<std::mutex> oLock(oMutex);
+                if (bStop)
+                    return;
+            }
 
-        for (int iRef = 0; iRef < ref.nfiles; iRef++)
-        {
-            papszCells = CSLAddString(papszCells, ref.file[iRef].name);
-            papszMapsets = CSLAddString(papszMapsets, ref.file[iRef].mapset);
-            G_add_mapset_to_search_path(ref.file[iRef].mapset);
-        }
+            bOK = ReadRow(iRow, aabyRows);
+            if (!bOK)
+                break;
 
-        I_free_group_ref(&ref);
+            const int nLastRow = std::min(iRow + nStep, nBufYSize) - 1;
+            CopyRows(iRow, nLastRow, aabyRows);
+
+            std::lock_guard<std::mutex> oLock(oMutex);
+            if (nUpdatedFirstRow < 0)
+            {
+                nUpdatedFirstRow = iRow;
+                nUpdatedLastRow = nLastRow;
+            }
+            else
+            {
+                nUpdatedFirstRow = std::min(nUpdatedFirstRow, iRow);
+                nUpdatedLastRow = std::max(nUpdatedLastRow, nLastRow);
+            }
+            oCond.notify_all();
+        }
     }
 
-    /* -------------------------------------------------------------------- */
-    /*      Create a corresponding GDALDataset.                             */
-    /* -------------------------------------------------------------------- */
-    auto poDS = new GRASSDataset(gp);
+    std::lock_guard<std::mutex> oLock(oMutex);
+    bDone = true;
+    bFailed = !bOK;
+    oCond.notify_all();
+}
 
-    /* notdef: should only allow read access to an existing cell, right? */
-    poDS->eAccess = poOpenInfo->eAccess;
+/************************************************************************/
+/*                              ReadRow()                               */
+/************************************************************************/
 
-    if (!papszCells)
+auto GRASSAsyncReader::ReadRow(int nRow,
+                               std::vector<std::vector<GByte>> &aabyRows)
+    -> bool
+{
+    // the GRASS libraries are not thread safe, the region is set again
+    // since another reader may have changed it in the meantime
+    GRASSSession::Lock oLock;
+    if (!bAllNative)
+        oLock = GRASSSession::Acquire();
+
+    for (size_t i = 0; i < apoBands.size(); i++)
     {
-        return nullptr;
+        if (apoBands[i]->BeginRead(&sWindow) != CE_None ||
+            apoBands[i]->ReadGRASSRow(&sWindow, nRow, aabyRows[i].data()) !=
+                CE_None)
+            return false;
     }
+    return true;
+}
 
-    /* -------------------------------------------------------------------- */
-    /*      Capture some information from the file that is of interest.     */
-    /* -------------------------------------------------------------------- */
+/************************************************************************/
+/*                              CopyRows()                              */
+/*                                                                      */
+/* Convert the rows read for buffer row nFirstRow into the buffer and   */
+/* copy them to the rows up to nLastRow.                                */
+/************************************************************************/
 
-    Rast_get_cellhd(papszCells[0], papszMapsets[0], &(poDS->sCellInfo));
+void GRASSAsyncReader::CopyRows(int nFirstRow, int nLastRow,
+                                std::vector<std::vector<GByte>> &aabyRows)
+{
+    std::lock_guard<std::timed_mutex> oLock(oBufferMutex);
 
-    poDS->nRasterXSize = poDS->sCellInfo.cols;
-    poDS->nRasterYSize = poDS->sCellInfo.rows;
+    for (size_t i = 0; i < apoBands.size(); i++)
+    {
+        GByte *pabyFirst = static_cast<GByte *>(pBuf) +
+                           static_cast<GSpacing>(nFirstRow) * nLineSpace +
+                           static_cast<GSpacing>(i) * nBandSpace;
+
+        // the conversion may modify the row read, copy the converted row
+        GRASSCopyRow(aabyRows[i].data(), apoBands[i]->nGRSType, pabyFirst,
+                     eBufType, nPixelSpace, nBufXSize, apoBands[i]->dfNoData);
+        for (int iRow = nFirstRow + 1; iRow <= nLastRow; iRow++)
+            GDALCopyWords(pabyFirst, eBufType, nPixelSpace,
+                          pabyFirst + static_cast<GSpacing>(iRow - nFirstRow) *
+                                          nLineSpace,
+                          eBufType, nPixelSpace, nBufXSize);
+    }
+}
 
-    poDS->m_gt[0] = poDS->sCellInfo.west;
-    poDS->m_gt[1] = poDS->sCellInfo.ew_res;
-    poDS->m_gt[2] = 0.0;
-    poDS->m_gt[3] = poDS->sCellInfo.north;
-    poDS->m_gt[4] = 0.0;
-    poDS->m_gt[5] = -1 * poDS->sCellInfo.ns_res;
+/************************************************************************/
+/*                        GetNextUpdatedRegion()                        */
+/*                                                                      */
+/* Wait up to dfTimeout seconds (forever if negative) for rows to be    */
+/* written, and return the full width range of the buffer rows written  */
+/* since the last call.                                                 */
+/************************************************************************/
 
-    /* -------------------------------------------------------------------- */
-    /*      Try to get a projection definition.                             */
-    /* -------------------------------------------------------------------- */
-    struct Key_Value *projinfo = G_get_projinfo();
-    struct Key_Value *projunits = G_get_projunits();
-
-    char *pszWKT = GPJ_grass_to_wkt(projinfo, projunits, 0, 0);
-    if (projinfo)
-        G_free_key_value(projinfo);
-    if (projunits)
-        G_free_key_value(projunits);
-    if (pszWKT)
-        poDS->m_oSRS.importFromWkt(pszWKT);
-    G_free(pszWKT);
+auto GRASSAsyncReader::GetNextUpdatedRegion(double dfTimeout, int *pnBufXOff,
+                                            int *pnBufYOff, int *pnBufXSize,
+                                            int *pnBufYSize)
+    -> GDALAsyncStatusType
+{
+    std::unique_lock<std::mutex> oLock(oMutex);
 
-    /* -------------------------------------------------------------------- */
-    /*      Create band information objects.                                */
-    /* -------------------------------------------------------------------- */
-    for (int iBand = 0; papszCells[iBand] != nullptr; iBand++)
+    auto IsUpdated = [this]() { return nUpdatedFirstRow >= 0 || bDone; };
+    if (dfTimeout < 0)
+        oCond.wait(oLock, IsUpdated);
+    else
+        oCond.wait_for(oLock, std::chrono::duration<double>(dfTimeout),
+                       IsUpdated);
+
+    *pnBufXOff = 0;
+    *pnBufYOff = 0;
+    *pnBufXSize = 0;
+    *pnBufYSize = 0;
+    if (nUpdatedFirstRow >= 0)
     {
-        std::string msets = std::string(papszMapsets[iBand]);
-        std::string cells = std::string(papszCells[iBand]);
-        auto rb = new GRASSRasterBand(poDS, iBand + 1, msets, cells);
-
-        if (!rb->valid)
-        {
-            CPLError(CE_Warning, CPLE_AppDefined,
-                     "GRASS: Cannot open raster band %d", iBand);
-            delete rb;
-            delete poDS;
-            return nullptr;
-        }
-
-        poDS->SetBand(iBand + 1, rb);
+        *pnBufYOff = nUpdatedFirstRow;
+        *pnBufXSize = nBufXSize;
+        *pnBufYSize = nUpdatedLastRow - nUpdatedFirstRow + 1;
+        nUpdatedFirstRow = -1;
+        nUpdatedLastRow = -1;
     }
 
-    CSLDestroy(papszCells);
-    CSLDestroy(papszMapsets);
+    if (!bDone)
+        return *pnBufYSize > 0 ? GARIO_UPDATE : GARIO_PENDING;
+    return bFailed ? GARIO_ERROR : GARIO_COMPLETE;
+}
 
-    /* -------------------------------------------------------------------- */
-    /*      Confirm the requested access is supported.                      */
-    /* -------------------------------------------------------------------- */
-    if (poOpenInfo->eAccess == GA_Update)
+/************************************************************************/
+/*                             LockBuffer()                             */
+/*                                                                      */
+/* Keep the decoder from writing to the buffer, waiting up to dfTimeout */
+/* seconds (forever if negative).                                       */
+/************************************************************************/
+
+auto GRASSAsyncReader::LockBuffer(double dfTimeout) -> int
+{
+    if (dfTimeout < 0)
     {
-        delete poDS;
-        CPLError(CE_Failure, CPLE_NotSupported,
-                 "The GRASS driver does not support update access to existing"
-                 " datasets.\n");
-        return nullptr;
+        oBufferMutex.lock();
+        return TRUE;
     }
+    return oBufferMutex.try_lock_for(std::chrono::duration<double>(dfTimeout))
+               ? TRUE
+               : FALSE;
+}
 
-    return poDS;
+/************************************************************************/
+/*                            UnlockBuffer()                            */
+/************************************************************************/
+
+void GRASSAsyncReader::UnlockBuffer()
+{
+    oBufferMutex.unlock();
 }
 
 /************************************************************************/
@@ -1100,6 +5251,17 @@ auto GRASSRasterPath::isCellHD() -> bool
     return element == "cellhd";
 }
 
+/************************************************************************/
+/*                          GRASSDriverUnload()                         */
+/************************************************************************/
+
+static void GRASSDriverUnload(GDALDriver *)
+{
+    GRASSSession::RemoveLocationChangeHandler(GRASSRasterBand::ReleaseHandles);
+    GRASSWorkerPool::Shutdown();
+    GRASSRowCache::Clear();
+}
+
 /************************************************************************/
 /*                          GDALRegister_GRASS()                        */
 /************************************************************************/
@@ -1118,8 +5280,46 @@ void GDALRegister_GRASS()
     poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
     poDriver->SetMetadataItem(GDAL_DMD_LONGNAME, "GRASS Rasters (7+)");
     poDriver->SetMetadataItem(GDAL_DMD_HELPTOPIC, "drivers/raster/grass.html");
-
+    poDriver->SetMetadataItem(GDAL_DMD_SUBDATASETS, "YES");
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 8, 0)
+    poDriver->SetMetadataItem(GDAL_DCAP_MULTIDIM_RASTER, "YES");
+#endif
+#ifdef GDAL_DMD_CONNECTION_PREFIX
+    poDriver->SetMetadataItem(GDAL_DMD_CONNECTION_PREFIX, "GRASS:");
+#endif
+    poDriver->SetMetadataItem(
+        GDAL_DMD_OPENOPTIONLIST,
+        "<OpenOptionList>"
+        "  <Option name='BLOCK_YSIZE' type='string' default='1' "
+        "description='Number of rows per block, or AUTO to size blocks to "
+        "the block cache'/>"
+        "  <Option name='NATIVE_DECODER' type='boolean' default='NO' "
+        "description='Decode raster rows in the driver instead of through "
+        "the GRASS library'/>"
+#ifndef _WIN32
+        "  <Option name='WORKER_PROCESSES' type='boolean' default='NO' "
+        "description='Decode rows in GDAL_NUM_THREADS worker processes'/>"
+#endif
+        "  <Option name='OVERVIEWS' type='string-select' default='USE' "
+        "description='Use of the overviews in cell_misc'>"
+        "    <Value>USE</Value>"
+        "    <Value>BUILD</Value>"
+        "    <Value>NONE</Value>"
+        "  </Option>"
+        "  <Option name='GROUP_MANIFEST' type='string-select' default='USE' "
+        "description='Use of the band headers cached in the group'>"
+        "    <Value>USE</Value>"
+        "    <Value>BUILD</Value>"
+        "    <Value>NONE</Value>"
+        "  </Option>"
+        "</OpenOptionList>");
+
+    poDriver->pfnIdentify = GRASSDataset::Identify;
     poDriver->pfnOpen = GRASSDataset::Open;
+    poDriver->pfnUnloadDriver = GRASSDriverUnload;
+
+    // rasters must be closed before any driver switches the location
+    GRASSSession::AddLocationChangeHandler(GRASSRasterBand::ReleaseHandles);
 
     GetGDALDriverManager()->RegisterDriver(poDriver);
 }
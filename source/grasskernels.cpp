@@ -0,0 +1,362 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Conversion of decoded GRASS raster rows to GDAL buffers.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "grasskernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* CELL null value, see Rast_set_c_null_value() */
+static constexpr CELL CELL_NULL = std::numeric_limits<CELL>::min();
+
+/************************************************************************/
+/*                            ClampCell()                               */
+/*                                                                      */
+/* CELL to destination type, saturating like GDALCopyWords().           */
+/************************************************************************/
+
+template <class T> static inline auto ClampCell(CELL nValue) -> T
+{
+    return static_cast<T>(nValue);
+}
+
+template <> inline auto ClampCell<GByte>(CELL nValue) -> GByte
+{
+    return static_cast<GByte>(std::min(std::max(nValue, 0), 255));
+}
+
+template <> inline auto ClampCell<GUInt16>(CELL nValue) -> GUInt16
+{
+    return static_cast<GUInt16>(std::min(std::max(nValue, 0), 65535));
+}
+
+template <> inline auto ClampCell<GInt16>(CELL nValue) -> GInt16
+{
+    return static_cast<GInt16>(std::min(std::max(nValue, -32768), 32767));
+}
+
+template <> inline auto ClampCell<GUInt32>(CELL nValue) -> GUInt32
+{
+    return static_cast<GUInt32>(std::max(nValue, 0));
+}
+
+/************************************************************************/
+/*                          CellRowSIMD()                               */
+/*                                                                      */
+/* Packed conversion of the leading cells, returns the number of cells  */
+/* done. Nulls are replaced before saturating to the destination range. */
+/************************************************************************/
+
+template <class T>
+static inline auto CellRowSIMD(const CELL *, T *, int, CELL) -> int
+{
+    return 0;
+}
+
+#if defined(__AVX2__)
+
+static inline auto ReplaceNulls(__m256i xValues, __m256i xNoData) -> __m256i
+{
+    const __m256i xNull = _mm256_set1_epi32(CELL_NULL);
+    return _mm256_blendv_epi8(xValues, xNoData,
+                              _mm256_cmpeq_epi32(xValues, xNull));
+}
+
+template <>
+inline auto CellRowSIMD<GByte>(const CELL *panSrc, GByte *pabyDst, int nCount,
+                               CELL nNoData) -> int
+{
+    const __m256i xNoData = _mm256_set1_epi32(nNoData);
+    // packing works per 128 bit lane, this puts the 32 bit groups back
+    const __m256i xOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int i = 0;
+
+    for (; i + 32 <= nCount; i += 32)
+    {
+        const auto pSrc = reinterpret_cast<const __m256i *>(panSrc + i);
+        const __m256i xA = ReplaceNulls(_mm256_loadu_si256(pSrc), xNoData);
+        const __m256i xB = ReplaceNulls(_mm256_loadu_si256(pSrc + 1), xNoData);
+        const __m256i xC = ReplaceNulls(_mm256_loadu_si256(pSrc + 2), xNoData);
+        const __m256i xD = ReplaceNulls(_mm256_loadu_si256(pSrc + 3), xNoData);
+        const __m256i xBytes =
+            _mm256_packus_epi16(_mm256_packs_epi32(xA, xB),
+                                _mm256_packs_epi32(xC, xD));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(pabyDst + i),
+                            _mm256_permutevar8x32_epi32(xBytes, xOrder));
+    }
+
+    return i;
+}
+
+template <>
+inline auto CellRowSIMD<GUInt16>(const CELL *panSrc, GUInt16 *panDst,
+                                 int nCount, CELL nNoData) -> int
+{
+    const __m256i xNoData = _mm256_set1_epi32(nNoData);
+    const __m256i xZero = _mm256_setzero_si256();
+    const __m256i xBias = _mm256_set1_epi32(32768);
+    const __m256i xSign = _mm256_set1_epi16(static_cast<short>(0x8000));
+    int i = 0;
+
+    // no unsigned 32 to 16 bit pack: clamp negatives to 0, pack with
+    // signed saturation around 32768 and flip the sign bit back
+    for (; i + 16 <= nCount; i += 16)
+    {
+        const auto pSrc = reinterpret_cast<const __m256i *>(panSrc + i);
+        __m256i xA = ReplaceNulls(_mm256_loadu_si256(pSrc), xNoData);
+        __m256i xB = ReplaceNulls(_mm256_loadu_si256(pSrc + 1), xNoData);
+        xA = _mm256_sub_epi32(_mm256_max_epi32(xA, xZero), xBias);
+        xB = _mm256_sub_epi32(_mm256_max_epi32(xB, xZero), xBias);
+        const __m256i xWords = _mm256_xor_si256(
+            _mm256_permute4x64_epi64(_mm256_packs_epi32(xA, xB), 0xD8), xSign);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(panDst + i), xWords);
+    }
+
+    return i;
+}
+
+#elif defined(__SSE2__)
+
+static inline auto ReplaceNulls(__m128i xValues, __m128i xNoData) -> __m128i
+{
+    const __m128i xMask =
+        _mm_cmpeq_epi32(xValues, _mm_set1_epi32(CELL_NULL));
+    return _mm_or_si128(_mm_and_si128(xMask, xNoData),
+                        _mm_andnot_si128(xMask, xValues));
+}
+
+template <>
+inline auto CellRowSIMD<GByte>(const CELL *panSrc, GByte *pabyDst, int nCount,
+                               CELL nNoData) -> int
+{
+    const __m128i xNoData = _mm_set1_epi32(nNoData);
+    int i = 0;
+
+    for (; i + 16 <= nCount; i += 16)
+    {
+        const auto pSrc = reinterpret_cast<const __m128i *>(panSrc + i);
+        const __m128i xA = ReplaceNulls(_mm_loadu_si128(pSrc), xNoData);
+        const __m128i xB = ReplaceNulls(_mm_loadu_si128(pSrc + 1), xNoData);
+        const __m128i xC = ReplaceNulls(_mm_loadu_si128(pSrc + 2), xNoData);
+        const __m128i xD = ReplaceNulls(_mm_loadu_si128(pSrc + 3), xNoData);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pabyDst + i),
+                         _mm_packus_epi16(_mm_packs_epi32(xA, xB),
+                                          _mm_packs_epi32(xC, xD)));
+    }
+
+    return i;
+}
+
+template <>
+inline auto CellRowSIMD<GUInt16>(const CELL *panSrc, GUInt16 *panDst,
+                                 int nCount, CELL nNoData) -> int
+{
+    const __m128i xNoData = _mm_set1_epi32(nNoData);
+    const __m128i xZero = _mm_setzero_si128();
+    const __m128i xBias = _mm_set1_epi32(32768);
+    const __m128i xSign = _mm_set1_epi16(static_cast<short>(0x8000));
+    int i = 0;
+
+    // no unsigned 32 to 16 bit pack nor 32 bit max in SSE2: zero the
+    // negatives, pack with signed saturation around 32768 and flip the
+    // sign bit back
+    for (; i + 8 <= nCount; i += 8)
+    {
+        const auto pSrc = reinterpret_cast<const __m128i *>(panSrc + i);
+        __m128i xA = ReplaceNulls(_mm_loadu_si128(pSrc), xNoData);
+        __m128i xB = ReplaceNulls(_mm_loadu_si128(pSrc + 1), xNoData);
+        xA = _mm_sub_epi32(_mm_and_si128(xA, _mm_cmpgt_epi32(xA, xZero)),
+                           xBias);
+        xB = _mm_sub_epi32(_mm_and_si128(xB, _mm_cmpgt_epi32(xB, xZero)),
+                           xBias);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(panDst + i),
+                         _mm_xor_si128(_mm_packs_epi32(xA, xB), xSign));
+    }
+
+    return i;
+}
+
+#endif
+
+/************************************************************************/
+/*                             CellRow()                                */
+/*                                                                      */
+/* Fused null replacement and conversion of a CELL row. nSpacing is the */
+/* pixel spacing when known at compile time (packed output), 0 if it    */
+/* is only known at run time.                                           */
+/************************************************************************/
+
+template <class T, int nSpacing>
+static void CellRow(const CELL *panSrc, GByte *pabyDst, int nPixelSpace,
+                    int nCount, CELL nNoData)
+{
+    const int nStep = nSpacing ? nSpacing : nPixelSpace;
+    int i = 0;
+
+    if (nSpacing == static_cast<int>(sizeof(T)))
+        i = CellRowSIMD<T>(panSrc, reinterpret_cast<T *>(pabyDst), nCount,
+                           nNoData);
+
+    for (; i < nCount; i++)
+    {
+        const CELL nValue = panSrc[i] == CELL_NULL ? nNoData : panSrc[i];
+        const T tValue = ClampCell<T>(nValue);
+        memcpy(pabyDst + static_cast<size_t>(i) * nStep, &tValue, sizeof(T));
+    }
+}
+
+template <class T>
+static void CellRowDispatch(const CELL *panSrc, GByte *pabyDst,
+                            int nPixelSpace, int nCount, CELL nNoData)
+{
+    if (nPixelSpace == static_cast<int>(sizeof(T)))
+        CellRow<T, sizeof(T)>(panSrc, pabyDst, nPixelSpace, nCount, nNoData);
+    else
+        CellRow<T, 0>(panSrc, pabyDst, nPixelSpace, nCount, nNoData);
+}
+
+/************************************************************************/
+/*                           GRASSCopyRow()                             */
+/************************************************************************/
+
+void GRASSCopyRow(void *pSrc, int nMapType, void *pDst, GDALDataType eDstType,
+                  int nPixelSpace, int nCount, double dfNoData)
+{
+    auto pabyDst = static_cast<GByte *>(pDst);
+
+    if (nMapType == CELL_TYPE)
+    {
+        auto panSrc = static_cast<CELL *>(pSrc);
+        const CELL nNoData = static_cast<CELL>(dfNoData);
+
+        switch (eDstType)
+        {
+            case GDT_Byte:
+                CellRowDispatch<GByte>(panSrc, pabyDst, nPixelSpace, nCount,
+                                       nNoData);
+                return;
+            case GDT_UInt16:
+                CellRowDispatch<GUInt16>(panSrc, pabyDst, nPixelSpace, nCount,
+                                         nNoData);
+                return;
+            case GDT_Int16:
+                CellRowDispatch<GInt16>(panSrc, pabyDst, nPixelSpace, nCount,
+                                        nNoData);
+                return;
+            case GDT_Int32:
+                CellRowDispatch<GInt32>(panSrc, pabyDst, nPixelSpace, nCount,
+                                        nNoData);
+                return;
+            case GDT_UInt32:
+                CellRowDispatch<GUInt32>(panSrc, pabyDst, nPixelSpace, nCount,
+                                         nNoData);
+                return;
+            case GDT_Float32:
+                CellRowDispatch<float>(panSrc, pabyDst, nPixelSpace, nCount,
+                                       nNoData);
+                return;
+            case GDT_Float64:
+                CellRowDispatch<double>(panSrc, pabyDst, nPixelSpace, nCount,
+                                        nNoData);
+                return;
+            default:
+                break;
+        }
+
+        for (int i = 0; i < nCount; i++)
+        {
+            if (panSrc[i] == CELL_NULL)
+                panSrc[i] = nNoData;
+        }
+        GDALCopyWords(panSrc, GDT_Int32, sizeof(CELL), pDst, eDstType,
+                      nPixelSpace, nCount);
+        return;
+    }
+
+    /* FCELL and DCELL nulls are NaN, usually also the nodata value */
+    if (!std::isnan(dfNoData))
+    {
+        if (nMapType == FCELL_TYPE)
+        {
+            auto pafSrc = static_cast<FCELL *>(pSrc);
+            for (int i = 0; i < nCount; i++)
+            {
+                if (std::isnan(pafSrc[i]))
+                    pafSrc[i] = static_cast<FCELL>(dfNoData);
+            }
+        }
+        else
+        {
+            auto padfSrc = static_cast<DCELL *>(pSrc);
+            for (int i = 0; i < nCount; i++)
+            {
+                if (std::isnan(padfSrc[i]))
+                    padfSrc[i] = dfNoData;
+            }
+        }
+    }
+
+    if (nMapType == FCELL_TYPE)
+        GDALCopyWords(pSrc, GDT_Float32, sizeof(FCELL), pDst, eDstType,
+                      nPixelSpace, nCount);
+    else
+        GDALCopyWords(pSrc, GDT_Float64, sizeof(DCELL), pDst, eDstType,
+                      nPixelSpace, nCount);
+}
+
+/************************************************************************/
+/*                          GRASSReclassRow()                           */
+/************************************************************************/
+
+void GRASSReclassRow(CELL *panRow, int nCount, const CELL *panTable,
+                     CELL nMin, CELL nMax)
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i xMin = _mm256_set1_epi32(nMin);
+    const __m256i xMax = _mm256_set1_epi32(nMax);
+    const __m256i xNull = _mm256_set1_epi32(CELL_NULL);
+
+    // nulls are below nMin, lanes outside the table are not gathered
+    for (; i + 8 <= nCount; i += 8)
+    {
+        const auto pRow = reinterpret_cast<__m256i *>(panRow + i);
+        const __m256i xValues = _mm256_loadu_si256(pRow);
+        const __m256i xOutside =
+            _mm256_or_si256(_mm256_cmpgt_epi32(xMin, xValues),
+                            _mm256_cmpgt_epi32(xValues, xMax));
+        const __m256i xIndex =
+            _mm256_andnot_si256(xOutside, _mm256_sub_epi32(xValues, xMin));
+        _mm256_storeu_si256(
+            pRow, _mm256_mask_i32gather_epi32(
+                      xNull, reinterpret_cast<const int *>(panTable), xIndex,
+                      _mm256_xor_si256(xOutside, _mm256_set1_epi32(-1)), 4));
+    }
+#endif
+
+    for (; i < nCount; i++)
+    {
+        const CELL nValue = panRow[i];
+        panRow[i] = nValue == CELL_NULL || nValue < nMin || nValue > nMax
+                        ? CELL_NULL
+                        : panTable[nValue - nMin];
+    }
+}
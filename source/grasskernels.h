@@ -0,0 +1,51 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Conversion of decoded GRASS raster rows to GDAL buffers.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSKERNELS_H_INCLUDED
+#define GRASSKERNELS_H_INCLUDED
+
+#include "gdal.h"
+
+extern "C"
+{
+#include <grass/gis.h>
+}
+
+/************************************************************************/
+/*                           GRASSCopyRow()                             */
+/*                                                                      */
+/* Copy nCount cells of a row read as CELL, FCELL or DCELL (nMapType)   */
+/* to pDst as eDstType, nPixelSpace bytes apart, replacing null cells   */
+/* by dfNoData, with the clamping and rounding of GDALCopyWords().      */
+/*                                                                      */
+/* CELL rows to Byte, UInt16, Int16, Int32, UInt32, Float32 and Float64 */
+/* are converted in a single pass by kernels specialized per type, with */
+/* SSE2 or AVX2 for packed Byte and UInt16 output. Other conversions    */
+/* may modify pSrc.                                                     */
+/************************************************************************/
+
+void GRASSCopyRow(void *pSrc, int nMapType, void *pDst, GDALDataType eDstType,
+                  int nPixelSpace, int nCount, double dfNoData);
+
+/************************************************************************/
+/*                          GRASSReclassRow()                           */
+/*                                                                      */
+/* Look the nCount cells of a CELL row of the base map of a reclass map */
+/* up in place in its table, panTable[i] being the category of base     */
+/* value nMin + i for values up to nMax. Nulls and values outside the   */
+/* table become null. Gathered with AVX2.                               */
+/************************************************************************/
+
+void GRASSReclassRow(CELL *panRow, int nCount, const CELL *panTable,
+                     CELL nMin, CELL nMax);
+
+#endif /* ndef GRASSKERNELS_H_INCLUDED */
@@ -0,0 +1,863 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  In-driver decoder for GRASS raster maps, independent of the
+ *           process global state of the GRASS libraries.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <climits>
+#include <cstring>
+
+#include "cpl_conv.h"
+#include "gdal.h"
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 4, 0)
+#include "cpl_compressor.h"
+#endif
+
+#include "grassnative.h"
+
+/* Compression methods, as stored in the "compressed" field of cellhd */
+enum
+{
+    GRASS_COMPRESSION_NONE = 0,
+    GRASS_COMPRESSION_RLE = 1,
+    GRASS_COMPRESSION_ZLIB = 2,
+    GRASS_COMPRESSION_LZ4 = 3,
+    GRASS_COMPRESSION_BZIP2 = 4,
+    GRASS_COMPRESSION_ZSTD = 5
+};
+
+/* Flag byte in front of rows written by G_write_compressed() */
+enum
+{
+    GRASS_ROW_RAW = '0',
+    GRASS_ROW_COMPRESSED = '1'
+};
+
+/************************************************************************/
+/*                       IsCompressionSupported()                       */
+/************************************************************************/
+
+static auto IsCompressionSupported(int nCompression) -> bool
+{
+    switch (nCompression)
+    {
+        case GRASS_COMPRESSION_NONE:
+        case GRASS_COMPRESSION_RLE:
+        case GRASS_COMPRESSION_ZLIB:
+            return true;
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 4, 0)
+        case GRASS_COMPRESSION_LZ4:
+            return CPLGetDecompressor("lz4") != nullptr;
+        case GRASS_COMPRESSION_ZSTD:
+            return CPLGetDecompressor("zstd") != nullptr;
+#endif
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                              Expand()                                */
+/*                                                                      */
+/* Equivalent of G_expand() for the methods supported natively.         */
+/* Returns true if exactly nDstSize bytes were decompressed.            */
+/************************************************************************/
+
+static auto Expand(int nCompression, const GByte *pabySrc, size_t nSrcSize,
+                   GByte *pabyDst, size_t nDstSize) -> bool
+{
+    if (nCompression == GRASS_COMPRESSION_ZLIB)
+    {
+        size_t nOutBytes = 0;
+        if (CPLZLibInflate(pabySrc, nSrcSize, pabyDst, nDstSize,
+                           &nOutBytes) == nullptr)
+            return false;
+        return nOutBytes == nDstSize;
+    }
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 4, 0)
+    if (nCompression == GRASS_COMPRESSION_LZ4 ||
+        nCompression == GRASS_COMPRESSION_ZSTD)
+    {
+        const bool bLZ4 = nCompression == GRASS_COMPRESSION_LZ4;
+        const CPLCompressor *psDecompressor =
+            CPLGetDecompressor(bLZ4 ? "lz4" : "zstd");
+        if (psDecompressor == nullptr)
+            return false;
+
+        // GRASS writes raw LZ4 blocks without the size header
+        const char *const apszLZ4Options[] = {"HEADER=NO", nullptr};
+        void *pOut = pabyDst;
+        size_t nOutBytes = nDstSize;
+        if (!psDecompressor->pfnFunc(pabySrc, nSrcSize, &pOut, &nOutBytes,
+                                     bLZ4 ? apszLZ4Options : nullptr,
+                                     psDecompressor->user_data))
+            return false;
+        return nOutBytes == nDstSize;
+    }
+#endif
+    return false;
+}
+
+/************************************************************************/
+/*                            RLEExpand()                               */
+/*                                                                      */
+/* Run length decoding of CELL rows: pairs of a repeat count byte and   */
+/* a value of nCellBytes bytes.                                         */
+/************************************************************************/
+
+static auto RLEExpand(const GByte *pabySrc, size_t nSrcSize, int nCellBytes,
+                      GByte *pabyDst, size_t nDstSize) -> bool
+{
+    const size_t nPairs = nSrcSize / (nCellBytes + 1);
+    size_t nOut = 0;
+
+    for (size_t i = 0; i < nPairs; i++)
+    {
+        const int nRepeat = *pabySrc++;
+        for (int j = 0; j < nRepeat; j++)
+        {
+            if (nOut + nCellBytes > nDstSize)
+                return false;
+            memcpy(pabyDst + nOut, pabySrc, nCellBytes);
+            nOut += nCellBytes;
+        }
+        pabySrc += nCellBytes;
+    }
+
+    return nOut == nDstSize;
+}
+
+/************************************************************************/
+/*                          ReadRowPointers()                           */
+/*                                                                      */
+/* Row address array of compressed files: one byte giving the size of   */
+/* the addresses, followed by rows + 1 big endian addresses.            */
+/************************************************************************/
+
+static auto ReadRowPointers(VSILFILE *fp, int nRows,
+                            std::vector<vsi_l_offset> &anRowPtr) -> bool
+{
+    GByte nPtrBytes = 0;
+
+    if (VSIFReadL(&nPtrBytes, 1, 1, fp) != 1 || nPtrBytes == 0 ||
+        nPtrBytes > sizeof(vsi_l_offset))
+        return false;
+
+    std::vector<GByte> abyBuf(static_cast<size_t>(nRows + 1) * nPtrBytes);
+    if (VSIFReadL(abyBuf.data(), 1, abyBuf.size(), fp) != abyBuf.size())
+        return false;
+
+    anRowPtr.resize(static_cast<size_t>(nRows) + 1);
+    const GByte *pabyPtr = abyBuf.data();
+    for (int iRow = 0; iRow <= nRows; iRow++)
+    {
+        vsi_l_offset nPtr = 0;
+        for (int i = 0; i < nPtrBytes; i++)
+            nPtr = (nPtr << 8) | *pabyPtr++;
+        if (iRow > 0 && nPtr < anRowPtr[iRow - 1])
+            return false;
+        anRowPtr[iRow] = nPtr;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                            FileExists()                              */
+/************************************************************************/
+
+static auto FileExists(const std::string &osFile) -> bool
+{
+    VSIStatBufL sStat;
+    return VSIStatL(osFile.c_str(), &sStat) == 0;
+}
+
+/************************************************************************/
+/*                        ~GRASSNativeRaster()                          */
+/************************************************************************/
+
+GRASSNativeRaster::~GRASSNativeRaster()
+{
+    if (psMappedData)
+        CPLVirtualMemFree(psMappedData);
+    if (fpMapped)
+        VSIFCloseL(fpMapped);
+    for (auto fp : apoFreeDataFiles)
+        VSIFCloseL(fp);
+    for (auto fp : apoFreeNullFiles)
+        VSIFCloseL(fp);
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/*                                                                      */
+/* sCellHead and nMapType are the header and type of the map as found   */
+/* by libgrass. Returns nullptr if the map cannot be decoded natively.  */
+/************************************************************************/
+
+auto GRASSNativeRaster::Open(const std::string &osMapsetPath,
+                             const std::string &osName,
+                             const struct Cell_head &sCellHead, int nMapType)
+    -> GRASSNativeRaster *
+{
+    const std::string osMisc = osMapsetPath + "/cell_misc/" + osName;
+
+    /* -------------------------------------------------------------------- */
+    /*      Refuse what libgrass resolves through other maps or files.      */
+    /* -------------------------------------------------------------------- */
+    VSILFILE *fp = VSIFOpenL((osMapsetPath + "/cellhd/" + osName).c_str(), "rb");
+    if (fp == nullptr)
+        return nullptr;
+    char szHeader[8] = {};
+    const size_t nRead = VSIFReadL(szHeader, 1, sizeof(szHeader) - 1, fp);
+    VSIFCloseL(fp);
+    if (nRead >= 7 && EQUALN(szHeader, "reclass", 7))
+    {
+        CPLDebug("GRASS", "%s is a reclass map, not decoded natively",
+                 osName.c_str());
+        return nullptr;
+    }
+
+    if (FileExists(osMisc + "/gdal") || FileExists(osMisc + "/vrt"))
+    {
+        CPLDebug("GRASS", "%s is linked or virtual, not decoded natively",
+                 osName.c_str());
+        return nullptr;
+    }
+
+    // libgrass applies the MASK of the current mapset to every row read
+    if (FileExists(osMapsetPath + "/cell/MASK"))
+    {
+        CPLDebug("GRASS", "MASK is active in %s, not decoding natively",
+                 osMapsetPath.c_str());
+        return nullptr;
+    }
+
+    auto poRaster = std::unique_ptr<GRASSNativeRaster>(new GRASSNativeRaster());
+    poRaster->sCellHead = sCellHead;
+    poRaster->nMapType = nMapType;
+    poRaster->nCompression = sCellHead.compressed;
+
+    if (nMapType == CELL_TYPE)
+    {
+        poRaster->osDataFile = osMapsetPath + "/cell/" + osName;
+        poRaster->nBytes = sCellHead.format + 1;
+        if (poRaster->nBytes < 1 || poRaster->nBytes > 4)
+            return nullptr;
+    }
+    else
+    {
+        poRaster->osDataFile = osMapsetPath + "/fcell/" + osName;
+        poRaster->nBytes = nMapType == FCELL_TYPE ? 4 : 8;
+        // Compression 1 of floating point maps means zlib
+        if (poRaster->nCompression == GRASS_COMPRESSION_RLE)
+            poRaster->nCompression = GRASS_COMPRESSION_ZLIB;
+    }
+
+    if (poRaster->nCompression < 0 ||
+        !IsCompressionSupported(poRaster->nCompression))
+    {
+        CPLDebug("GRASS", "Compression %d of %s is not decoded natively",
+                 sCellHead.compressed, osName.c_str());
+        return nullptr;
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Read the row address arrays.                                    */
+    /* -------------------------------------------------------------------- */
+    fp = VSIFOpenL(poRaster->osDataFile.c_str(), "rb");
+    if (fp == nullptr)
+        return nullptr;
+    if (poRaster->nCompression != GRASS_COMPRESSION_NONE &&
+        !ReadRowPointers(fp, sCellHead.rows, poRaster->anRowPtr))
+    {
+        CPLDebug("GRASS", "Cannot read row pointers of %s",
+                 poRaster->osDataFile.c_str());
+        VSIFCloseL(fp);
+        return nullptr;
+    }
+    poRaster->apoFreeDataFiles.push_back(fp);
+
+    if (FileExists(osMisc + "/nullcmpr"))
+    {
+        // compressed null files are always LZ4 compressed
+        if (!IsCompressionSupported(GRASS_COMPRESSION_LZ4))
+            return nullptr;
+        poRaster->osNullFile = osMisc + "/nullcmpr";
+        poRaster->bNullCompressed = true;
+    }
+    else if (FileExists(osMisc + "/null"))
+    {
+        poRaster->osNullFile = osMisc + "/null";
+    }
+
+    if (!poRaster->osNullFile.empty())
+    {
+        fp = VSIFOpenL(poRaster->osNullFile.c_str(), "rb");
+        if (fp == nullptr)
+            return nullptr;
+        if (poRaster->bNullCompressed &&
+            !ReadRowPointers(fp, sCellHead.rows, poRaster->anNullRowPtr))
+        {
+            VSIFCloseL(fp);
+            return nullptr;
+        }
+        poRaster->apoFreeNullFiles.push_back(fp);
+    }
+
+    return poRaster.release();
+}
+
+/************************************************************************/
+/*                            AcquireFile()                             */
+/************************************************************************/
+
+auto GRASSNativeRaster::AcquireFile(bool bNullFile) -> VSILFILE *
+{
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        auto &apoFree = bNullFile ? apoFreeNullFiles : apoFreeDataFiles;
+        if (!apoFree.empty())
+        {
+            VSILFILE *fp = apoFree.back();
+            apoFree.pop_back();
+            return fp;
+        }
+    }
+
+    return VSIFOpenL(bNullFile ? osNullFile.c_str() : osDataFile.c_str(),
+                     "rb");
+}
+
+/************************************************************************/
+/*                            ReleaseFile()                             */
+/************************************************************************/
+
+void GRASSNativeRaster::ReleaseFile(bool bNullFile, VSILFILE *fp)
+{
+    std::lock_guard<std::mutex> oLock(oMutex);
+    (bNullFile ? apoFreeNullFiles : apoFreeDataFiles).push_back(fp);
+}
+
+/************************************************************************/
+/*                           GetColumnMap()                             */
+/*                                                                      */
+/* Same mapping as Rast__create_window_mapping(): for each window       */
+/* column, the file column containing the center of the window cell.    */
+/************************************************************************/
+
+auto GRASSNativeRaster::GetColumnMap(const struct Cell_head &sWindow)
+    -> std::shared_ptr<const ColumnMap>
+{
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        if (poColumnMap && poColumnMap->sWindow.west == sWindow.west &&
+            poColumnMap->sWindow.ew_res == sWindow.ew_res &&
+            poColumnMap->sWindow.cols == sWindow.cols &&
+            poColumnMap->sWindow.proj == sWindow.proj)
+        {
+            return poColumnMap;
+        }
+    }
+
+    auto poMap = std::make_shared<ColumnMap>();
+    poMap->sWindow = sWindow;
+    poMap->anCols.resize(sWindow.cols);
+
+    double dfWest = sWindow.west;
+    if (sWindow.proj == PROJECTION_LL)
+    {
+        while (dfWest > sCellHead.west + 360.0)
+            dfWest -= 360.0;
+        while (dfWest < sCellHead.west)
+            dfWest += 360.0;
+    }
+
+    const double dfC1 = sWindow.ew_res / sCellHead.ew_res;
+    for (int nPass = 0; nPass < (sWindow.proj == PROJECTION_LL ? 2 : 1);
+         nPass++)
+    {
+        // the second pass wraps around for lat/lon
+        double dfC2 = (dfWest - (nPass ? 360.0 : 0.0) - sCellHead.west +
+                       sWindow.ew_res / 2.0) /
+                      sCellHead.ew_res;
+        for (int i = 0; i < sWindow.cols; i++)
+        {
+            int x = static_cast<int>(dfC2);
+            if (dfC2 < x) /* adjust for rounding of negatives */
+                x--;
+            if (x < 0 || x >= sCellHead.cols)
+                x = -1;
+            if (poMap->anCols[i] == 0)
+                poMap->anCols[i] = x + 1;
+            dfC2 += dfC1;
+        }
+    }
+
+    std::lock_guard<std::mutex> oLock(oMutex);
+    poColumnMap = poMap;
+    return poMap;
+}
+
+/************************************************************************/
+/*                            GetFileRow()                              */
+/*                                                                      */
+/* Same mapping as compute_window_row() in libgrass, -1 if outside.     */
+/************************************************************************/
+
+auto GRASSNativeRaster::GetFileRow(const struct Cell_head &sWindow,
+                                   int nRow) const -> int
+{
+    const double dfC1 = sWindow.ns_res / sCellHead.ns_res;
+    const double dfC2 =
+        (sCellHead.north - sWindow.north + sWindow.ns_res / 2.0) /
+        sCellHead.ns_res;
+    const double f = nRow * dfC1 + dfC2;
+    int r = static_cast<int>(f);
+    if (f < r) /* adjust for rounding of negatives */
+        r--;
+
+    if (r < 0 || r >= sCellHead.rows)
+        return -1;
+
+    return r;
+}
+
+/************************************************************************/
+/*                            ReadDataRow()                             */
+/*                                                                      */
+/* Read and decompress a row of the data file into abyRow. nRowBytes is */
+/* set to the number of bytes per cell, which may vary per row for      */
+/* compressed CELL maps.                                                */
+/************************************************************************/
+
+auto GRASSNativeRaster::ReadDataRow(VSILFILE *fp, int nFileRow,
+                                    std::vector<GByte> &abyRow,
+                                    int &nRowBytes) const -> bool
+{
+    const size_t nCols = static_cast<size_t>(sCellHead.cols);
+    nRowBytes = nBytes;
+
+    if (nCompression == GRASS_COMPRESSION_NONE)
+    {
+        abyRow.resize(nCols * nBytes);
+        return VSIFSeekL(fp, static_cast<vsi_l_offset>(nFileRow) * abyRow.size(),
+                         SEEK_SET) == 0 &&
+               VSIFReadL(abyRow.data(), 1, abyRow.size(), fp) == abyRow.size();
+    }
+
+    const vsi_l_offset nOffset = anRowPtr[nFileRow];
+    const size_t nSize =
+        static_cast<size_t>(anRowPtr[nFileRow + 1] - anRowPtr[nFileRow]);
+    if (nSize < 1)
+        return false;
+
+    std::vector<GByte> abyCompressed(nSize);
+    if (VSIFSeekL(fp, nOffset, SEEK_SET) != 0 ||
+        VSIFReadL(abyCompressed.data(), 1, nSize, fp) != nSize)
+        return false;
+
+    if (nMapType == CELL_TYPE)
+    {
+        // first byte is the number of bytes per cell of this row
+        nRowBytes = abyCompressed[0];
+        if (nRowBytes < 1 || nRowBytes > 4)
+            return false;
+        abyRow.resize(nCols * nRowBytes);
+        if (nSize - 1 >= abyRow.size())
+        {
+            memcpy(abyRow.data(), abyCompressed.data() + 1, abyRow.size());
+            return true;
+        }
+        if (nCompression == GRASS_COMPRESSION_RLE)
+            return RLEExpand(abyCompressed.data() + 1, nSize - 1, nRowBytes,
+                             abyRow.data(), abyRow.size());
+        return Expand(nCompression, abyCompressed.data() + 1, nSize - 1,
+                      abyRow.data(), abyRow.size());
+    }
+
+    abyRow.resize(nCols * nBytes);
+    if (abyCompressed[0] == GRASS_ROW_RAW)
+    {
+        if (nSize - 1 < abyRow.size())
+            return false;
+        memcpy(abyRow.data(), abyCompressed.data() + 1, abyRow.size());
+        return true;
+    }
+    if (abyCompressed[0] != GRASS_ROW_COMPRESSED)
+        return false;
+
+    return Expand(nCompression, abyCompressed.data() + 1, nSize - 1,
+                  abyRow.data(), abyRow.size());
+}
+
+/************************************************************************/
+/*                            ReadNullRow()                             */
+/*                                                                      */
+/* Read the null bits of a file row, one bit per cell, most significant */
+/* bit first, set for null cells.                                       */
+/************************************************************************/
+
+auto GRASSNativeRaster::ReadNullRow(VSILFILE *fp, int nFileRow,
+                                    std::vector<GByte> &abyNulls) const -> bool
+{
+    const size_t nSize = (static_cast<size_t>(sCellHead.cols) + 7) / 8;
+    abyNulls.resize(nSize);
+
+    if (!bNullCompressed)
+    {
+        return VSIFSeekL(fp, static_cast<vsi_l_offset>(nFileRow) * nSize,
+                         SEEK_SET) == 0 &&
+               VSIFReadL(abyNulls.data(), 1, nSize, fp) == nSize;
+    }
+
+    const size_t nCompressedSize = static_cast<size_t>(
+        anNullRowPtr[nFileRow + 1] - anNullRowPtr[nFileRow]);
+    if (nCompressedSize < 1)
+        return false;
+
+    std::vector<GByte> abyCompressed(nCompressedSize);
+    if (VSIFSeekL(fp, anNullRowPtr[nFileRow], SEEK_SET) != 0 ||
+        VSIFReadL(abyCompressed.data(), 1, nCompressedSize, fp) !=
+            nCompressedSize)
+        return false;
+
+    if (abyCompressed[0] == GRASS_ROW_RAW)
+    {
+        if (nCompressedSize - 1 < nSize)
+            return false;
+        memcpy(abyNulls.data(), abyCompressed.data() + 1, nSize);
+        return true;
+    }
+    if (abyCompressed[0] != GRASS_ROW_COMPRESSED)
+        return false;
+
+    return Expand(GRASS_COMPRESSION_LZ4, abyCompressed.data() + 1,
+                  nCompressedSize - 1, abyNulls.data(), nSize);
+}
+
+/************************************************************************/
+/*                              ReadRow()                               */
+/*                                                                      */
+/* Read row nRow of sWindow into pBuffer as CELL, FCELL or DCELL        */
+/* (the map type) with GRASS null values, like Rast_get_c_row(),        */
+/* Rast_get_f_row() and Rast_get_d_row() do for a map of that type.     */
+/************************************************************************/
+
+auto GRASSNativeRaster::ReadRow(const struct Cell_head &sWindow, int nRow,
+                                void *pBuffer) -> bool
+{
+    const int nCols = sWindow.cols;
+    const int nFileRow = GetFileRow(sWindow, nRow);
+
+    if (nFileRow < 0)
+    {
+        // outside of the map: all null
+        if (nMapType == CELL_TYPE)
+        {
+            auto panBuffer = static_cast<CELL *>(pBuffer);
+            for (int i = 0; i < nCols; i++)
+                panBuffer[i] = INT_MIN;
+        }
+        else
+        {
+            memset(pBuffer, 0xff, static_cast<size_t>(nCols) * nBytes);
+        }
+        return true;
+    }
+
+    auto poMap = GetColumnMap(sWindow);
+
+    std::vector<GByte> abyRow;
+    int nRowBytes = 0;
+    VSILFILE *fp = AcquireFile(false);
+    if (fp == nullptr)
+        return false;
+    const bool bDataOK = ReadDataRow(fp, nFileRow, abyRow, nRowBytes);
+    ReleaseFile(false, fp);
+    if (!bDataOK)
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "GRASS: Cannot read row %d of %s",
+                 nFileRow, osDataFile.c_str());
+        return false;
+    }
+
+    std::vector<GByte> abyNulls;
+    if (!osNullFile.empty())
+    {
+        fp = AcquireFile(true);
+        if (fp == nullptr)
+            return false;
+        const bool bNullOK = ReadNullRow(fp, nFileRow, abyNulls);
+        ReleaseFile(true, fp);
+        if (!bNullOK)
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "GRASS: Cannot read null row %d of %s", nFileRow,
+                     osNullFile.c_str());
+            return false;
+        }
+    }
+
+    const int *panCols = poMap->anCols.data();
+    const GByte *pabyNulls = abyNulls.empty() ? nullptr : abyNulls.data();
+
+    if (nMapType == CELL_TYPE)
+    {
+        auto panBuffer = static_cast<CELL *>(pBuffer);
+        const bool bSignMagnitude = nRowBytes >= 4;
+
+        for (int i = 0; i < nCols; i++)
+        {
+            const int nCol = panCols[i] - 1;
+            if (nCol < 0 ||
+                (pabyNulls && (pabyNulls[nCol >> 3] & (0x80 >> (nCol & 7)))))
+            {
+                panBuffer[i] = INT_MIN;
+                continue;
+            }
+
+            // big endian, 4 byte values are stored as sign and magnitude
+            const GByte *pabyCell =
+                abyRow.data() + static_cast<size_t>(nCol) * nRowBytes;
+            bool bNegative = false;
+            GUInt32 nMagnitude = *pabyCell;
+            if (bSignMagnitude && (nMagnitude & 0x80))
+            {
+                bNegative = true;
+                nMagnitude &= 0x7f;
+            }
+            for (int j = 1; j < nRowBytes; j++)
+                nMagnitude = (nMagnitude << 8) | pabyCell[j];
+            CELL nValue = static_cast<CELL>(nMagnitude);
+            if (bNegative)
+                nValue = -nValue;
+
+            // without null file, libgrass treats 0 as null in CELL maps
+            if (pabyNulls == nullptr && nValue == 0)
+                nValue = INT_MIN;
+
+            panBuffer[i] = nValue;
+        }
+    }
+    else
+    {
+        auto pabyBuffer = static_cast<GByte *>(pBuffer);
+
+        for (int i = 0; i < nCols; i++)
+        {
+            GByte *pabyDst = pabyBuffer + static_cast<size_t>(i) * nBytes;
+            const int nCol = panCols[i] - 1;
+            if (nCol < 0 ||
+                (pabyNulls && (pabyNulls[nCol >> 3] & (0x80 >> (nCol & 7)))))
+            {
+                memset(pabyDst, 0xff, nBytes);
+                continue;
+            }
+            memcpy(pabyDst,
+                   abyRow.data() + static_cast<size_t>(nCol) * nBytes, nBytes);
+        }
+
+        // XDR is big endian IEEE
+#ifdef CPL_LSB
+        GDALSwapWords(pBuffer, nBytes, nCols, nBytes);
+#endif
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                           ReadNullMask()                             */
+/*                                                                      */
+/* Expand the null bits of row nRow of sWindow to a GDAL mask. Cells    */
+/* outside of the map are null. Requires a null file.                   */
+/************************************************************************/
+
+auto GRASSNativeRaster::ReadNullMask(const struct Cell_head &sWindow, int nRow,
+                                     GByte *pabyMask) -> bool
+{
+    const int nCols = sWindow.cols;
+    const int nFileRow = GetFileRow(sWindow, nRow);
+
+    if (nFileRow < 0)
+    {
+        memset(pabyMask, 0, nCols);
+        return true;
+    }
+
+    if (osNullFile.empty())
+        return false;
+
+    auto poMap = GetColumnMap(sWindow);
+
+    std::vector<GByte> abyNulls;
+    VSILFILE *fp = AcquireFile(true);
+    if (fp == nullptr)
+        return false;
+    const bool bNullOK = ReadNullRow(fp, nFileRow, abyNulls);
+    ReleaseFile(true, fp);
+    if (!bNullOK)
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "GRASS: Cannot read null row %d of %s", nFileRow,
+                 osNullFile.c_str());
+        return false;
+    }
+
+    const int *panCols = poMap->anCols.data();
+    const GByte *pabyNulls = abyNulls.data();
+
+    for (int i = 0; i < nCols; i++)
+    {
+        const int nCol = panCols[i] - 1;
+        pabyMask[i] =
+            (nCol < 0 || (pabyNulls[nCol >> 3] & (0x80 >> (nCol & 7)))) ? 0
+                                                                        : 255;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                           HasNullCells()                             */
+/*                                                                      */
+/* Whether any bit of the null file is set. Unused bits at the end of   */
+/* the rows are ignored.                                                */
+/************************************************************************/
+
+auto GRASSNativeRaster::HasNullCells() -> bool
+{
+    if (osNullFile.empty())
+        return false;
+
+    VSILFILE *fp = AcquireFile(true);
+    if (fp == nullptr)
+        return true;
+
+    const int nTailBits = sCellHead.cols % 8;
+    const GByte nTailMask =
+        nTailBits ? static_cast<GByte>(0xff << (8 - nTailBits)) : 0xff;
+    std::vector<GByte> abyNulls;
+    bool bNulls = false;
+
+    for (int iRow = 0; iRow < sCellHead.rows && !bNulls; iRow++)
+    {
+        if (!ReadNullRow(fp, iRow, abyNulls))
+        {
+            bNulls = true;
+            break;
+        }
+        abyNulls.back() &= nTailMask;
+        for (GByte nBits : abyNulls)
+        {
+            if (nBits)
+            {
+                bNulls = true;
+                break;
+            }
+        }
+    }
+
+    ReleaseFile(true, fp);
+    return bNulls;
+}
+
+/************************************************************************/
+/*                            IsMappable()                              */
+/*                                                                      */
+/* The data file of an uncompressed map is an array of rows with a      */
+/* fixed size. Null cells are stored as 0 and only marked in the null   */
+/* file, so the raw data is usable as is only if there are none.        */
+/************************************************************************/
+
+auto GRASSNativeRaster::IsMappable() -> bool
+{
+    if (nCompression != GRASS_COMPRESSION_NONE ||
+        !CPLIsVirtualMemFileMapAvailable())
+        return false;
+
+    VSIStatBufL sStat;
+    const vsi_l_offset nSize = static_cast<vsi_l_offset>(sCellHead.rows) *
+                               sCellHead.cols * nBytes;
+    if (VSIStatL(osDataFile.c_str(), &sStat) != 0 ||
+        static_cast<vsi_l_offset>(sStat.st_size) < nSize)
+        return false;
+
+    return !HasNullCells();
+}
+
+/************************************************************************/
+/*                            GetMappedData()                           */
+/*                                                                      */
+/* Address of the raw (big endian) rows of the whole map, nullptr if    */
+/* the map cannot be read this way. Row r starts at r * cols * the      */
+/* number of bytes per cell.                                            */
+/************************************************************************/
+
+auto GRASSNativeRaster::GetMappedData() -> const GByte *
+{
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        if (nMappedState > 0)
+            return static_cast<const GByte *>(
+                CPLVirtualMemGetAddr(psMappedData));
+        if (nMappedState < 0)
+            return nullptr;
+    }
+
+    // scanning the null file takes the mutex, so check it without
+    const bool bMappable = IsMappable();
+
+    std::lock_guard<std::mutex> oLock(oMutex);
+    if (nMappedState == 0)
+    {
+        nMappedState = -1;
+        if (bMappable)
+        {
+            fpMapped = VSIFOpenL(osDataFile.c_str(), "rb");
+            if (fpMapped)
+                psMappedData = CPLVirtualMemFileMapNew(
+                    fpMapped, 0,
+                    static_cast<vsi_l_offset>(sCellHead.rows) *
+                        sCellHead.cols * nBytes,
+                    VIRTUALMEM_READONLY, nullptr, nullptr);
+        }
+        if (psMappedData)
+        {
+            nMappedState = 1;
+            CPLDebug("GRASS", "%s is memory mapped", osDataFile.c_str());
+        }
+    }
+
+    if (nMappedState < 0)
+        return nullptr;
+
+    return static_cast<const GByte *>(CPLVirtualMemGetAddr(psMappedData));
+}
+
+/************************************************************************/
+/*                              MapData()                               */
+/*                                                                      */
+/* New mapping of the data file for GetVirtualMemAuto(), owned by the   */
+/* caller. Same conditions as GetMappedData().                          */
+/************************************************************************/
+
+auto GRASSNativeRaster::MapData() -> CPLVirtualMem *
+{
+    if (GetMappedData() == nullptr)
+        return nullptr;
+
+    std::lock_guard<std::mutex> oLock(oMutex);
+    return CPLVirtualMemFileMapNew(
+        fpMapped, 0,
+        static_cast<vsi_l_offset>(sCellHead.rows) * sCellHead.cols * nBytes,
+        VIRTUALMEM_READONLY, nullptr, nullptr);
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  In-driver decoder for GRASS raster maps, independent of the
+ *           process global state of the GRASS libraries.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSNATIVE_H_INCLUDED
+#define GRASSNATIVE_H_INCLUDED
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cpl_virtualmem.h"
+#include "cpl_vsi.h"
+
+extern "C"
+{
+#include <grass/gis.h>
+}
+
+/************************************************************************/
+/*                          GRASSNativeRaster                           */
+/*                                                                      */
+/* Reads the rows of a CELL, FCELL or DCELL map directly from the cell  */
+/* or fcell file, the row pointer table and the null file. Rows are     */
+/* resampled to a window the same way as libgrass does it.              */
+/*                                                                      */
+/* All state is per object and reads may be issued from several threads */
+/* at once. Maps which cannot be decoded (reclass, external links,      */
+/* virtual rasters, unsupported compression, active MASK) are refused   */
+/* by Open() so that the caller can fall back to libgrass.              */
+/************************************************************************/
+class GRASSNativeRaster
+{
+  public:
+    ~GRASSNativeRaster();
+
+    static auto Open(const std::string &osMapsetPath, const std::string &osName,
+                     const struct Cell_head &sCellHead, int nMapType)
+        -> GRASSNativeRaster *;
+
+    auto GetMapType() const -> int
+    {
+        return nMapType;
+    }
+
+    auto GetCellHead() const -> const struct Cell_head &
+    {
+        return sCellHead;
+    }
+
+    /* Bytes per cell in the data file, for uncompressed maps */
+    auto GetCellBytes() const -> int
+    {
+        return nBytes;
+    }
+
+    auto HasNullFile() const -> bool
+    {
+        return !osNullFile.empty();
+    }
+
+    auto ReadRow(const struct Cell_head &sWindow, int nRow, void *pBuffer)
+        -> bool;
+
+    /* Validity of a row from the null file alone, 255 valid, 0 null */
+    auto ReadNullMask(const struct Cell_head &sWindow, int nRow,
+                      GByte *pabyMask) -> bool;
+
+    /* Raw rows of uncompressed maps without null cells, mapped in memory */
+    auto GetMappedData() -> const GByte *;
+    auto MapData() -> CPLVirtualMem *;
+
+  private:
+    GRASSNativeRaster() = default;
+
+    struct ColumnMap
+    {
+        struct Cell_head sWindow;
+        std::vector<int> anCols; /* file column + 1, 0 if outside */
+    };
+
+    std::string osDataFile{};
+    std::string osNullFile{};
+    struct Cell_head sCellHead
+    {
+    };
+    int nMapType{CELL_TYPE};
+    int nCompression{0};  /* 0 none, 1 RLE, 2 ZLIB, 3 LZ4, 4 BZIP2, 5 ZSTD */
+    int nBytes{0};        /* bytes per cell of uncompressed rows */
+    bool bNullCompressed{false};
+
+    std::vector<vsi_l_offset> anRowPtr{};
+    std::vector<vsi_l_offset> anNullRowPtr{};
+
+    /* Idle file handles of the data and the null file, handles in use are
+     * owned by the reading thread. oMutex protects these and poColumnMap. */
+    std::mutex oMutex{};
+    std::vector<VSILFILE *> apoFreeDataFiles{};
+    std::vector<VSILFILE *> apoFreeNullFiles{};
+    std::shared_ptr<const ColumnMap> poColumnMap{};
+
+    /* Memory mapping of the data file, see GetMappedData(). oMutex
+     * protects these as well. */
+    int nMappedState{0}; /* 0 not tried yet, 1 mapped, -1 not mappable */
+    VSILFILE *fpMapped{nullptr};
+    CPLVirtualMem *psMappedData{nullptr};
+
+    auto AcquireFile(bool bNullFile) -> VSILFILE *;
+    void ReleaseFile(bool bNullFile, VSILFILE *fp);
+    auto GetColumnMap(const struct Cell_head &sWindow)
+        -> std::shared_ptr<const ColumnMap>;
+    auto GetFileRow(const struct Cell_head &sWindow, int nRow) const -> int;
+    auto ReadDataRow(VSILFILE *fp, int nFileRow, std::vector<GByte> &abyRow,
+                     int &nRowBytes) const -> bool;
+    auto ReadNullRow(VSILFILE *fp, int nFileRow,
+                     std::vector<GByte> &abyNulls) const -> bool;
+    auto IsMappable() -> bool;
+    auto HasNullCells() -> bool;
+};
+
+#endif /* ndef GRASSNATIVE_H_INCLUDED */
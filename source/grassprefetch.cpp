@@ -0,0 +1,217 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Background decoding of the raster rows a reader will ask for
+ *           next.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include "cpl_error.h"
+
+#include "grassprefetch.h"
+
+namespace
+{
+
+/* Memory and threads used by the prefetchers of the process */
+struct PrefetchBudget
+{
+    std::mutex oMutex{};
+    size_t nBytes{0};
+    int nThreads{0};
+};
+
+auto GetBudget() -> PrefetchBudget &
+{
+    static PrefetchBudget oBudget;
+    return oBudget;
+}
+
+}  // namespace
+
+/************************************************************************/
+/*                               Start()                                */
+/*                                                                      */
+/* A prefetcher gets an equal share of nMaxBytes per thread, less if    */
+/* its range is shorter or the budget left is smaller, and is not       */
+/* started without room for a row.                                      */
+/************************************************************************/
+
+auto GRASSRowPrefetcher::Start(const RowReader &pfnReader, size_t nRowBytes,
+                               int nFirstRow, int nEndRow, size_t nMaxBytes,
+                               int nMaxThreads) -> GRASSRowPrefetcher *
+{
+    if (nFirstRow >= nEndRow || nRowBytes == 0 || nMaxThreads <= 0)
+        return nullptr;
+
+    PrefetchBudget &oBudget = GetBudget();
+    size_t nReserved = 0;
+    {
+        std::lock_guard<std::mutex> oLock(oBudget.oMutex);
+        if (oBudget.nThreads >= nMaxThreads || oBudget.nBytes >= nMaxBytes)
+            return nullptr;
+
+        nReserved = std::min(
+            {nMaxBytes / nMaxThreads, nMaxBytes - oBudget.nBytes,
+             static_cast<size_t>(nEndRow - nFirstRow) * nRowBytes});
+        nReserved -= nReserved % nRowBytes;
+        if (nReserved == 0)
+            return nullptr;
+
+        oBudget.nBytes += nReserved;
+        oBudget.nThreads++;
+    }
+
+    return new GRASSRowPrefetcher(pfnReader, nRowBytes, nFirstRow, nEndRow,
+                                  nReserved);
+}
+
+/************************************************************************/
+/*                         GRASSRowPrefetcher()                         */
+/*                                                                      */
+/* Keep at most nReservedBytes of decoded rows in the queue.            */
+/************************************************************************/
+
+GRASSRowPrefetcher::GRASSRowPrefetcher(const RowReader &pfnReaderIn,
+                                       size_t nRowBytesIn, int nFirstRow,
+                                       int nEndRowIn, size_t nReservedBytesIn)
+    : pfnReader(pfnReaderIn), nRowBytes(nRowBytesIn), nEndRow(nEndRowIn),
+      nReservedBytes(nReservedBytesIn),
+      nMaxRows(nReservedBytesIn / nRowBytesIn), nQueueFirstRow(nFirstRow),
+      nNextRow(nFirstRow)
+{
+    oThread = std::thread([this]() { Run(); });
+}
+
+/************************************************************************/
+/*                        ~GRASSRowPrefetcher()                         */
+/************************************************************************/
+
+GRASSRowPrefetcher::~GRASSRowPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bStop = true;
+    }
+    oCond.notify_all();
+    oThread.join();
+
+    PrefetchBudget &oBudget = GetBudget();
+    std::lock_guard<std::mutex> oLock(oBudget.oMutex);
+    oBudget.nBytes -= nReservedBytes;
+}
+
+/************************************************************************/
+/*                                Run()                                 */
+/************************************************************************/
+
+void GRASSRowPrefetcher::Run()
+{
+    // the caller reports errors when it reads the row itself
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+
+    std::vector<GByte> abyRow(nRowBytes);
+
+    while (true)
+    {
+        int nRow = 0;
+        {
+            std::unique_lock<std::mutex> oLock(oMutex);
+            oCond.wait(oLock,
+                       [this]()
+                       {
+                           return bStop || nNextRow >= nEndRow ||
+                                  aoQueue.size() < nMaxRows;
+                       });
+            if (bStop || nNextRow >= nEndRow)
+                break;
+            nRow = nNextRow++;
+        }
+
+        const bool bOK = pfnReader(nRow, abyRow.data());
+
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            if (!bOK)
+            {
+                bFailed = true;
+                oCond.notify_all();
+                break;
+            }
+            // rows skipped by the reader in the meantime are dropped
+            if (nRow == nQueueFirstRow + static_cast<int>(aoQueue.size()))
+                aoQueue.push_back(abyRow);
+        }
+        oCond.notify_all();
+    }
+
+    CPLPopErrorHandler();
+
+    // the thread is given back, decoded rows stay until taken
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bDone = true;
+    }
+    oCond.notify_all();
+
+    PrefetchBudget &oBudget = GetBudget();
+    std::lock_guard<std::mutex> oLock(oBudget.oMutex);
+    oBudget.nThreads--;
+}
+
+/************************************************************************/
+/*                                Take()                                */
+/************************************************************************/
+
+auto GRASSRowPrefetcher::Take(int nRow, void *pRow) -> bool
+{
+    std::unique_lock<std::mutex> oLock(oMutex);
+
+    if (nRow < nQueueFirstRow || nRow >= nEndRow)
+        return false;
+
+    // the rows before nRow are not needed anymore
+    bool bDropped = false;
+    while (!aoQueue.empty() && nQueueFirstRow < nRow)
+    {
+        aoQueue.pop_front();
+        nQueueFirstRow++;
+        bDropped = true;
+    }
+    if (aoQueue.empty() && nQueueFirstRow < nRow)
+    {
+        // skip ahead, the row being decoded (if any) will be dropped
+        nQueueFirstRow = nRow;
+        nNextRow = nRow;
+        bDropped = true;
+    }
+    if (bDropped)
+        oCond.notify_all();
+
+    oCond.wait(oLock,
+               [this]() { return !aoQueue.empty() || bFailed || bDone; });
+    if (aoQueue.empty())
+        return false;
+
+    // kept until a later row is taken, the row may be read again
+    memcpy(pRow, aoQueue.front().data(), nRowBytes);
+    return true;
+}
+
+/************************************************************************/
+/*                               Covers()                               */
+/************************************************************************/
+
+auto GRASSRowPrefetcher::Covers(int nRow) -> bool
+{
+    std::lock_guard<std::mutex> oLock(oMutex);
+    return !bFailed && nRow >= nQueueFirstRow && nRow < nEndRow;
+}
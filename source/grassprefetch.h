@@ -0,0 +1,86 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Background decoding of the raster rows a reader will ask for
+ *           next.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSPREFETCH_H_INCLUDED
+#define GRASSPREFETCH_H_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cpl_port.h"
+
+/************************************************************************/
+/*                          GRASSRowPrefetcher                          */
+/*                                                                      */
+/* Decodes a range of rows in order in a background thread into a      */
+/* bounded queue, while the reader processes the previous ones. Taking  */
+/* a row drops the rows before it; a row behind the queue is not        */
+/* served and must be read by the caller. The row reader is called in   */
+/* the background thread and must do its own locking.                   */
+/*                                                                      */
+/* The memory of the queues and the number of threads are bounded for  */
+/* the whole process; a prefetcher is not started beyond them.          */
+/************************************************************************/
+class GRASSRowPrefetcher
+{
+  public:
+    /* Decode row nRow into pRow, false on error */
+    using RowReader = std::function<bool(int nRow, void *pRow)>;
+
+    /* Start decoding rows nFirstRow to nEndRow - 1, nullptr if the
+     * prefetchers of the process already use nMaxThreads threads or all
+     * of nMaxBytes. */
+    static auto Start(const RowReader &pfnReader, size_t nRowBytes,
+                      int nFirstRow, int nEndRow, size_t nMaxBytes,
+                      int nMaxThreads) -> GRASSRowPrefetcher *;
+    ~GRASSRowPrefetcher();
+
+    /* Copy row nRow into pRow, waiting for it if needed. False if the row
+     * is not in the remaining range or could not be decoded. */
+    auto Take(int nRow, void *pRow) -> bool;
+
+    /* Whether nRow is in the remaining range */
+    auto Covers(int nRow) -> bool;
+
+  private:
+    GRASSRowPrefetcher(const RowReader &pfnReader, size_t nRowBytes,
+                       int nFirstRow, int nEndRow, size_t nReservedBytes);
+    GRASSRowPrefetcher(const GRASSRowPrefetcher &) = delete;
+    GRASSRowPrefetcher &operator=(const GRASSRowPrefetcher &) = delete;
+
+    void Run();
+
+    RowReader pfnReader;
+    size_t nRowBytes;
+    int nEndRow;
+    size_t nReservedBytes; /* taken from the budget of the process */
+    size_t nMaxRows;
+
+    /* all below protected by oMutex */
+    std::mutex oMutex{};
+    std::condition_variable oCond{};
+    std::deque<std::vector<GByte>> aoQueue{};
+    int nQueueFirstRow; /* row of aoQueue.front() or of the next row */
+    int nNextRow;       /* next row to decode */
+    bool bStop{false};
+    bool bFailed{false};
+    bool bDone{false}; /* the thread ended, no more rows will come */
+
+    std::thread oThread{};
+};
+
+#endif /* ndef GRASSPREFETCH_H_INCLUDED */
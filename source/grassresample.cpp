@@ -0,0 +1,458 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Streaming resampling of decoded GRASS raster rows.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "grassresample.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Tolerance on source coordinates falling on a pixel edge */
+static constexpr double EDGE_EPSILON = 1e-10;
+
+/* Share of the full cubic kernel weight the valid source cells must
+ * carry, below it renormalizing would amplify the few cells left */
+static constexpr double CUBIC_MIN_VALID_WEIGHT = 0.5;
+
+/************************************************************************/
+/*                           KernelWeight()                             */
+/*                                                                      */
+/* Triangle kernel for bilinear, Catmull-Rom (a = -0.5) for cubic, as   */
+/* used by GDAL for the same resampling names.                          */
+/************************************************************************/
+
+static auto KernelWeight(GDALRIOResampleAlg eAlg, double dfX) -> double
+{
+    dfX = std::fabs(dfX);
+
+    if (eAlg == GRIORA_Bilinear)
+        return dfX < 1.0 ? 1.0 - dfX : 0.0;
+
+    const double dfA = -0.5;
+    if (dfX <= 1.0)
+        return ((dfA + 2.0) * dfX - (dfA + 3.0)) * dfX * dfX + 1.0;
+    if (dfX < 2.0)
+        return ((dfA * dfX - 5.0 * dfA) * dfX + 8.0 * dfA) * dfX - 4.0 * dfA;
+    return 0.0;
+}
+
+/************************************************************************/
+/*                           WeightedSums()                             */
+/*                                                                      */
+/* Sums of the weighted values and of the weighted validities. The      */
+/* compiler does not vectorize floating point reductions without        */
+/* -ffast-math, so the SSE2 version is written out, two lanes at once.  */
+/************************************************************************/
+
+static inline void WeightedSums(const double *padfW, const double *padfV,
+                                const double *padfM, int nCount,
+                                double &dfSum, double &dfWeight)
+{
+    int k = 0;
+    dfSum = 0.0;
+    dfWeight = 0.0;
+
+#if defined(__SSE2__)
+    __m128d xSum = _mm_setzero_pd();
+    __m128d xWeight = _mm_setzero_pd();
+    for (; k + 2 <= nCount; k += 2)
+    {
+        const __m128d xW = _mm_loadu_pd(padfW + k);
+        xSum = _mm_add_pd(xSum, _mm_mul_pd(xW, _mm_loadu_pd(padfV + k)));
+        xWeight =
+            _mm_add_pd(xWeight, _mm_mul_pd(xW, _mm_loadu_pd(padfM + k)));
+    }
+    xSum = _mm_add_sd(xSum, _mm_unpackhi_pd(xSum, xSum));
+    xWeight = _mm_add_sd(xWeight, _mm_unpackhi_pd(xWeight, xWeight));
+    dfSum = _mm_cvtsd_f64(xSum);
+    dfWeight = _mm_cvtsd_f64(xWeight);
+#endif
+
+    for (; k < nCount; k++)
+    {
+        dfSum += padfW[k] * padfV[k];
+        dfWeight += padfW[k] * padfM[k];
+    }
+}
+
+/************************************************************************/
+/*                             Supports()                               */
+/************************************************************************/
+
+auto GRASSResampler::Supports(GDALRIOResampleAlg eAlg) -> bool
+{
+    return eAlg == GRIORA_Average || eAlg == GRIORA_Mode ||
+           eAlg == GRIORA_Bilinear || eAlg == GRIORA_Cubic;
+}
+
+/************************************************************************/
+/*                            Axis::Init()                              */
+/************************************************************************/
+
+void GRASSResampler::Axis::Init(GDALRIOResampleAlg eAlg, double dfOff,
+                                double dfSize, int nRasterSize, int nBufSize)
+{
+    const double dfRatio = dfSize / nBufSize;
+    int nMinStart = nRasterSize;
+    int nMaxEnd = 0;
+
+    anStart.resize(nBufSize);
+    anCount.resize(nBufSize);
+    anWeightOff.resize(nBufSize);
+
+    for (int i = 0; i < nBufSize; i++)
+    {
+        const double dfSrc0 = dfOff + i * dfRatio;
+        const double dfSrc1 = dfSrc0 + dfRatio;
+        const size_t nWeightOff = adfWeights.size();
+        int nStart = 0;
+        int nEnd = 0;
+
+        if (eAlg == GRIORA_Average || eAlg == GRIORA_Mode)
+        {
+            nStart = static_cast<int>(std::floor(dfSrc0 + EDGE_EPSILON));
+            nEnd = static_cast<int>(std::ceil(dfSrc1 - EDGE_EPSILON));
+            nStart = std::min(std::max(nStart, 0), nRasterSize - 1);
+            nEnd = std::min(std::max(nEnd, nStart + 1), nRasterSize);
+
+            for (int k = nStart; k < nEnd; k++)
+            {
+                /* share of the source pixel covered by the output pixel */
+                const double dfWeight =
+                    eAlg == GRIORA_Mode
+                        ? 1.0
+                        : std::min(k + 1.0, dfSrc1) - std::max(k + 0.0, dfSrc0);
+                adfWeights.push_back(std::max(dfWeight, 0.0));
+            }
+        }
+        else
+        {
+            /* the kernel is stretched when downsampling */
+            const double dfScale = std::max(dfRatio, 1.0);
+            const double dfRadius =
+                (eAlg == GRIORA_Bilinear ? 1.0 : 2.0) * dfScale;
+            const double dfCenter = dfSrc0 + dfRatio / 2 - 0.5;
+
+            nStart = static_cast<int>(std::ceil(dfCenter - dfRadius));
+            nEnd = static_cast<int>(std::floor(dfCenter + dfRadius)) + 1;
+            nStart = std::max(nStart, 0);
+            nEnd = std::min(nEnd, nRasterSize);
+            if (nEnd <= nStart)
+            {
+                nStart = static_cast<int>(std::floor(dfCenter + 0.5));
+                nStart = std::min(std::max(nStart, 0), nRasterSize - 1);
+                nEnd = nStart + 1;
+            }
+
+            for (int k = nStart; k < nEnd; k++)
+                adfWeights.push_back(
+                    KernelWeight(eAlg, (k - dfCenter) / dfScale));
+        }
+
+        /* clamped to the raster edge, away from the kernel */
+        if (std::all_of(adfWeights.begin() + nWeightOff, adfWeights.end(),
+                        [](double dfWeight) { return dfWeight == 0.0; }))
+            std::fill(adfWeights.begin() + nWeightOff, adfWeights.end(), 1.0);
+
+        adfTotal.push_back(
+            std::accumulate(adfWeights.begin() + nWeightOff, adfWeights.end(),
+                            0.0));
+        anStart[i] = nStart;
+        anCount[i] = nEnd - nStart;
+        anWeightOff[i] = nWeightOff;
+        nMinStart = std::min(nMinStart, nStart);
+        nMaxEnd = std::max(nMaxEnd, nEnd);
+    }
+
+    nSrcOff = nMinStart;
+    nSrcSize = nMaxEnd - nMinStart;
+    for (auto &nStart : anStart)
+        nStart -= nSrcOff;
+}
+
+/************************************************************************/
+/*                        Axis::SetSrcWindow()                          */
+/*                                                                      */
+/* Widen the source window, the starts stay relative to its offset.     */
+/************************************************************************/
+
+void GRASSResampler::Axis::SetSrcWindow(int nOff, int nSize)
+{
+    for (auto &nStart : anStart)
+        nStart += nSrcOff - nOff;
+    nSrcOff = nOff;
+    nSrcSize = nSize;
+}
+
+/************************************************************************/
+/*                          GRASSResampler()                            */
+/************************************************************************/
+
+GRASSResampler::GRASSResampler(GDALRIOResampleAlg eAlgIn, double dfXOff,
+                               double dfYOff, double dfXSize, double dfYSize,
+                               int nRasterXSize, int nRasterYSize,
+                               int nBufXSize, int nBufYSize)
+    : eAlg(eAlgIn)
+{
+    oX.Init(eAlg, dfXOff, dfXSize, nRasterXSize, nBufXSize);
+    oY.Init(eAlg, dfYOff, dfYSize, nRasterYSize, nBufYSize);
+
+    adfSum.resize(nBufXSize);
+    adfWeight.resize(nBufXSize);
+
+    if (eAlg != GRIORA_Cubic)
+        return;
+
+    /* the bilinear kernel is narrower, the union is for the clamping */
+    oXBilinear.Init(GRIORA_Bilinear, dfXOff, dfXSize, nRasterXSize,
+                    nBufXSize);
+    oYBilinear.Init(GRIORA_Bilinear, dfYOff, dfYSize, nRasterYSize,
+                    nBufYSize);
+    for (Axis *poAxis : {&oX, &oY})
+    {
+        Axis &oBilinear = poAxis == &oX ? oXBilinear : oYBilinear;
+        const int nOff = std::min(poAxis->nSrcOff, oBilinear.nSrcOff);
+        const int nEnd = std::max(poAxis->nSrcOff + poAxis->nSrcSize,
+                                  oBilinear.nSrcOff + oBilinear.nSrcSize);
+        poAxis->SetSrcWindow(nOff, nEnd - nOff);
+        oBilinear.SetSrcWindow(nOff, nEnd - nOff);
+    }
+
+    adfSumBilinear.resize(nBufXSize);
+    adfWeightBilinear.resize(nBufXSize);
+}
+
+/************************************************************************/
+/*                              PushRow()                               */
+/************************************************************************/
+
+void GRASSResampler::PushRow(const double *padfRow)
+{
+    oRows.emplace_back();
+    Row &oRow = oRows.back();
+
+    oRow.adfValue.resize(oX.nSrcSize);
+    oRow.adfValid.resize(oX.nSrcSize);
+    for (int i = 0; i < oX.nSrcSize; i++)
+    {
+        const bool bValid = !std::isnan(padfRow[i]);
+        oRow.adfValue[i] = bValid ? padfRow[i] : 0.0;
+        oRow.adfValid[i] = bValid ? 1.0 : 0.0;
+    }
+
+    if (eAlg != GRIORA_Mode)
+    {
+        ReduceRow(oX, oRow, oRow.adfSum, oRow.adfWeight);
+        if (eAlg == GRIORA_Cubic)
+            ReduceRow(oXBilinear, oRow, oRow.adfSumBilinear,
+                      oRow.adfWeightBilinear);
+        std::vector<double>().swap(oRow.adfValue);
+        std::vector<double>().swap(oRow.adfValid);
+    }
+}
+
+/************************************************************************/
+/*                             ReduceRow()                              */
+/*                                                                      */
+/* Horizontal pass of the separable kernels along oAxis. Nulls are 0   */
+/* with a 0 validity, so the sums have no branch.                       */
+/************************************************************************/
+
+void GRASSResampler::ReduceRow(const Axis &oAxis, const Row &oRow,
+                               std::vector<double> &adfRowSum,
+                               std::vector<double> &adfRowWeight)
+{
+    const size_t nBufXSize = oAxis.anStart.size();
+
+    adfRowSum.resize(nBufXSize);
+    adfRowWeight.resize(nBufXSize);
+
+    for (size_t i = 0; i < nBufXSize; i++)
+    {
+        WeightedSums(oAxis.adfWeights.data() + oAxis.anWeightOff[i],
+                     oRow.adfValue.data() + oAxis.anStart[i],
+                     oRow.adfValid.data() + oAxis.anStart[i],
+                     oAxis.anCount[i], adfRowSum[i], adfRowWeight[i]);
+    }
+}
+
+/************************************************************************/
+/*                            CombineRows()                             */
+/*                                                                      */
+/* Vertical pass of the separable kernels along oAxis, over the rows    */
+/* reduced with the kernel or its bilinear fallback. The loops run      */
+/* across the output columns and are vectorized by the compiler.        */
+/************************************************************************/
+
+void GRASSResampler::CombineRows(const Axis &oAxis, int nOutRow,
+                                 bool bBilinear,
+                                 std::vector<double> &adfOutSum,
+                                 std::vector<double> &adfOutWeight) const
+{
+    const double *padfW = oAxis.adfWeights.data() + oAxis.anWeightOff[nOutRow];
+    const int nRowStart = oAxis.anStart[nOutRow];
+    const size_t nBufXSize = adfOutSum.size();
+    double *padfSum = adfOutSum.data();
+    double *padfWeight = adfOutWeight.data();
+
+    std::fill(adfOutSum.begin(), adfOutSum.end(), 0.0);
+    std::fill(adfOutWeight.begin(), adfOutWeight.end(), 0.0);
+
+    for (int r = 0; r < oAxis.anCount[nOutRow]; r++)
+    {
+        const Row &oRow = oRows[nRowStart + r - nFirstRow];
+        const double *padfRowSum =
+            bBilinear ? oRow.adfSumBilinear.data() : oRow.adfSum.data();
+        const double *padfRowWeight =
+            bBilinear ? oRow.adfWeightBilinear.data() : oRow.adfWeight.data();
+        const double dfW = padfW[r];
+
+        for (size_t i = 0; i < nBufXSize; i++)
+        {
+            padfSum[i] += dfW * padfRowSum[i];
+            padfWeight[i] += dfW * padfRowWeight[i];
+        }
+    }
+}
+
+/************************************************************************/
+/*                              ModeRow()                               */
+/*                                                                      */
+/* Most frequent valid value of each output pixel, the smallest one on  */
+/* ties.                                                                */
+/************************************************************************/
+
+void GRASSResampler::ModeRow(int nOutRow, double *padfOut) const
+{
+    const size_t nBufXSize = oX.anStart.size();
+    const int nRowStart = oY.anStart[nOutRow];
+    const int nRowCount = oY.anCount[nOutRow];
+    std::vector<double> adfValues;
+
+    for (size_t i = 0; i < nBufXSize; i++)
+    {
+        adfValues.clear();
+        for (int r = 0; r < nRowCount; r++)
+        {
+            const Row &oRow = oRows[nRowStart + r - nFirstRow];
+            for (int k = oX.anStart[i]; k < oX.anStart[i] + oX.anCount[i]; k++)
+            {
+                if (oRow.adfValid[k] != 0.0)
+                    adfValues.push_back(oRow.adfValue[k]);
+            }
+        }
+
+        if (adfValues.empty())
+        {
+            padfOut[i] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+
+        std::sort(adfValues.begin(), adfValues.end());
+        double dfMode = adfValues[0];
+        size_t nModeCount = 0;
+        for (size_t k = 0; k < adfValues.size();)
+        {
+            size_t nEnd = k + 1;
+            while (nEnd < adfValues.size() && adfValues[nEnd] == adfValues[k])
+                nEnd++;
+            if (nEnd - k > nModeCount)
+            {
+                dfMode = adfValues[k];
+                nModeCount = nEnd - k;
+            }
+            k = nEnd;
+        }
+        padfOut[i] = dfMode;
+    }
+}
+
+/************************************************************************/
+/*                              NextRow()                               */
+/************************************************************************/
+
+auto GRASSResampler::NextRow(double *padfOut) -> bool
+{
+    const int nBufYSize = static_cast<int>(oY.anStart.size());
+    if (nNextOutRow >= nBufYSize)
+        return false;
+
+    int nRowEnd = oY.anStart[nNextOutRow] + oY.anCount[nNextOutRow];
+    if (eAlg == GRIORA_Cubic)
+        nRowEnd = std::max(nRowEnd, oYBilinear.anStart[nNextOutRow] +
+                                        oYBilinear.anCount[nNextOutRow]);
+    if (nFirstRow + static_cast<int>(oRows.size()) < nRowEnd)
+        return false;
+
+    if (eAlg == GRIORA_Mode)
+    {
+        ModeRow(nNextOutRow, padfOut);
+    }
+    else
+    {
+        const size_t nBufXSize = adfSum.size();
+        CombineRows(oY, nNextOutRow, false, adfSum, adfWeight);
+
+        /* the full kernel weight is the product of the axis totals */
+        const double dfMinWeight =
+            eAlg == GRIORA_Cubic
+                ? CUBIC_MIN_VALID_WEIGHT * oY.adfTotal[nNextOutRow]
+                : 0.0;
+        bool bBilinear = false;
+        for (size_t i = 0; i < nBufXSize && dfMinWeight > 0.0 && !bBilinear;
+             i++)
+            bBilinear = adfWeight[i] < dfMinWeight * oX.adfTotal[i];
+        if (bBilinear)
+        {
+            CombineRows(oYBilinear, nNextOutRow, true, adfSumBilinear,
+                        adfWeightBilinear);
+            for (size_t i = 0; i < nBufXSize; i++)
+            {
+                if (adfWeight[i] < dfMinWeight * oX.adfTotal[i])
+                {
+                    adfSum[i] = adfSumBilinear[i];
+                    adfWeight[i] = adfWeightBilinear[i];
+                }
+            }
+        }
+
+        for (size_t i = 0; i < nBufXSize; i++)
+        {
+            padfOut[i] = std::fabs(adfWeight[i]) > EDGE_EPSILON
+                             ? adfSum[i] / adfWeight[i]
+                             : std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+    nNextOutRow++;
+
+    /* drop the rows the next output rows do not use */
+    int nKeep = nFirstRow;
+    if (nNextOutRow < nBufYSize)
+    {
+        nKeep = oY.anStart[nNextOutRow];
+        if (eAlg == GRIORA_Cubic)
+            nKeep = std::min(nKeep, oYBilinear.anStart[nNextOutRow]);
+    }
+    while (nFirstRow < nKeep && !oRows.empty())
+    {
+        oRows.pop_front();
+        nFirstRow++;
+    }
+
+    return true;
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Streaming resampling of decoded GRASS raster rows.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSRESAMPLE_H_INCLUDED
+#define GRASSRESAMPLE_H_INCLUDED
+
+#include <deque>
+#include <vector>
+
+#include "gdal.h"
+
+/************************************************************************/
+/*                            GRASSResampler                            */
+/*                                                                      */
+/* Resamples a source window to a buffer size with the average, mode,   */
+/* bilinear or cubic kernel while the source rows are read, keeping     */
+/* only the rows the next output row depends on. Null cells are given   */
+/* as NaN and left out of the kernels; output cells without any valid   */
+/* source cell are NaN. Cubic output cells whose valid source cells     */
+/* carry too little of the kernel weight use the bilinear kernel.       */
+/*                                                                      */
+/* The kernels are separable (except mode): each source row is          */
+/* reduced to the output columns once, then the output rows combine     */
+/* the reduced rows.                                                    */
+/************************************************************************/
+class GRASSResampler
+{
+  public:
+    static auto Supports(GDALRIOResampleAlg eAlg) -> bool;
+
+    GRASSResampler(GDALRIOResampleAlg eAlg, double dfXOff, double dfYOff,
+                   double dfXSize, double dfYSize, int nRasterXSize,
+                   int nRasterYSize, int nBufXSize, int nBufYSize);
+
+    /* Source window to read, in raster pixels */
+    auto GetSrcXOff() const -> int
+    {
+        return oX.nSrcOff;
+    }
+
+    auto GetSrcYOff() const -> int
+    {
+        return oY.nSrcOff;
+    }
+
+    auto GetSrcXSize() const -> int
+    {
+        return oX.nSrcSize;
+    }
+
+    auto GetSrcYSize() const -> int
+    {
+        return oY.nSrcSize;
+    }
+
+    /* Add the next source row, GetSrcXSize() values */
+    void PushRow(const double *padfRow);
+
+    /* Compute the next output row, false if more source rows are needed */
+    auto NextRow(double *padfOut) -> bool;
+
+  private:
+    /* Source pixels and weights of each output pixel along one axis */
+    struct Axis
+    {
+        int nSrcOff{0};
+        int nSrcSize{0};
+        std::vector<int> anStart{}; /* relative to nSrcOff */
+        std::vector<int> anCount{};
+        std::vector<size_t> anWeightOff{};
+        std::vector<double> adfWeights{};
+        std::vector<double> adfTotal{}; /* sum of the weights */
+
+        void Init(GDALRIOResampleAlg eAlg, double dfOff, double dfSize,
+                  int nRasterSize, int nBufSize);
+        void SetSrcWindow(int nOff, int nSize);
+    };
+
+    /* A source row with nulls as 0 and the matching validity (0 or 1),
+     * and its reduction to the output columns */
+    struct Row
+    {
+        std::vector<double> adfValue{};
+        std::vector<double> adfValid{};
+        std::vector<double> adfSum{};    /* weighted sum of the values */
+        std::vector<double> adfWeight{}; /* sum of the weights used */
+        std::vector<double> adfSumBilinear{}; /* cubic only */
+        std::vector<double> adfWeightBilinear{};
+    };
+
+    static void ReduceRow(const Axis &oAxis, const Row &oRow,
+                          std::vector<double> &adfRowSum,
+                          std::vector<double> &adfRowWeight);
+    void CombineRows(const Axis &oAxis, int nOutRow, bool bBilinear,
+                     std::vector<double> &adfOutSum,
+                     std::vector<double> &adfOutWeight) const;
+    void ModeRow(int nOutRow, double *padfOut) const;
+
+    GDALRIOResampleAlg eAlg;
+    Axis oX{};
+    Axis oY{};
+    Axis oXBilinear{}; /* fallback of the cubic kernel */
+    Axis oYBilinear{};
+
+    std::deque<Row> oRows{};
+    int nFirstRow{0}; /* source row of oRows.front() */
+    int nNextOutRow{0};
+
+    std::vector<double> adfSum{};
+    std::vector<double> adfWeight{};
+    std::vector<double> adfSumBilinear{};
+    std::vector<double> adfWeightBilinear{};
+};
+
+#endif /* ndef GRASSRESAMPLE_H_INCLUDED */
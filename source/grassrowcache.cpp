@@ -0,0 +1,201 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Process wide cache of decoded GRASS raster rows.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cpl_conv.h"
+
+#include "grassrowcache.h"
+
+namespace
+{
+
+struct KeyHash
+{
+    auto operator()(const GRASSRowCache::Key &oKey) const -> size_t
+    {
+        size_t nHash = std::hash<std::string>()(oKey.osMap);
+        for (const size_t nValue :
+             {std::hash<GIntBig>()(oKey.nMTime),
+              std::hash<GIntBig>()(oKey.nSize),
+              std::hash<GIntBig>()(oKey.nMaskMTime),
+              std::hash<double>()(oKey.dfNorth),
+              std::hash<double>()(oKey.dfWest), std::hash<int>()(oKey.nCols),
+              std::hash<int>()(oKey.nMapType), std::hash<int>()(oKey.nRow)})
+            nHash = nHash * 31 + nValue;
+        return nHash;
+    }
+};
+
+struct Entry
+{
+    GRASSRowCache::Key oKey{};
+    std::vector<GByte> abyRow{};
+};
+
+struct CacheState
+{
+    std::mutex oMutex{};
+    std::list<Entry> oEntries{}; /* most recently used first */
+    std::unordered_map<GRASSRowCache::Key, std::list<Entry>::iterator,
+                       KeyHash>
+        oIndex{};
+    GRASSRowCache::Statistics sStatistics{};
+};
+
+auto GetState() -> CacheState &
+{
+    static CacheState oState;
+    return oState;
+}
+
+/* Memory accounted for an entry */
+auto EntryBytes(const GRASSRowCache::Key &oKey, size_t nRowBytes) -> size_t
+{
+    return sizeof(Entry) + oKey.osMap.size() + nRowBytes;
+}
+
+auto EntryBytes(const Entry &oEntry) -> size_t
+{
+    return EntryBytes(oEntry.oKey, oEntry.abyRow.size());
+}
+
+auto GetBudget() -> size_t
+{
+    const int nMB = atoi(CPLGetConfigOption("GRASS_ROW_CACHE_MB", "32"));
+    return nMB > 0 ? static_cast<size_t>(nMB) * 1024 * 1024 : 0;
+}
+
+}  // namespace
+
+/************************************************************************/
+/*                             operator==()                             */
+/************************************************************************/
+
+auto GRASSRowCache::Key::operator==(const Key &oOther) const -> bool
+{
+    return nRow == oOther.nRow && nMapType == oOther.nMapType &&
+           nRows == oOther.nRows && nCols == oOther.nCols &&
+           dfNorth == oOther.dfNorth && dfSouth == oOther.dfSouth &&
+           dfEast == oOther.dfEast && dfWest == oOther.dfWest &&
+           nMTime == oOther.nMTime && nSize == oOther.nSize &&
+           nMaskMTime == oOther.nMaskMTime && osMap == oOther.osMap;
+}
+
+/************************************************************************/
+/*                             IsEnabled()                              */
+/************************************************************************/
+
+auto GRASSRowCache::IsEnabled() -> bool
+{
+    return GetBudget() > 0;
+}
+
+/************************************************************************/
+/*                                Get()                                 */
+/************************************************************************/
+
+auto GRASSRowCache::Get(const Key &oKey, void *pRow, size_t nRowBytes) -> bool
+{
+    CacheState &oState = GetState();
+    std::lock_guard<std::mutex> oLock(oState.oMutex);
+
+    auto oIter = oState.oIndex.find(oKey);
+    if (oIter == oState.oIndex.end() ||
+        oIter->second->abyRow.size() != nRowBytes)
+    {
+        oState.sStatistics.nMisses++;
+        return false;
+    }
+
+    oState.oEntries.splice(oState.oEntries.begin(), oState.oEntries,
+                           oIter->second);
+    memcpy(pRow, oIter->second->abyRow.data(), nRowBytes);
+    oState.sStatistics.nHits++;
+    return true;
+}
+
+/************************************************************************/
+/*                                Put()                                 */
+/*                                                                      */
+/* Least recently used rows are evicted to stay within the budget, a    */
+/* budget lowered since the last call applies at once.                  */
+/************************************************************************/
+
+void GRASSRowCache::Put(const Key &oKey, const void *pRow, size_t nRowBytes)
+{
+    const size_t nBudget = GetBudget();
+    // a row which cannot fit does not evict the others
+    const size_t nEntryBytes = EntryBytes(oKey, nRowBytes);
+    if (nEntryBytes > nBudget)
+        return;
+
+    CacheState &oState = GetState();
+    std::lock_guard<std::mutex> oLock(oState.oMutex);
+
+    auto oIter = oState.oIndex.find(oKey);
+    if (oIter != oState.oIndex.end())
+    {
+        oState.sStatistics.nBytes -= EntryBytes(*oIter->second);
+        oState.oEntries.erase(oIter->second);
+        oState.oIndex.erase(oIter);
+    }
+
+    Entry oEntry;
+    oEntry.oKey = oKey;
+    oEntry.abyRow.assign(static_cast<const GByte *>(pRow),
+                         static_cast<const GByte *>(pRow) + nRowBytes);
+
+    while (!oState.oEntries.empty() &&
+           oState.sStatistics.nBytes + nEntryBytes > nBudget)
+    {
+        oState.sStatistics.nBytes -= EntryBytes(oState.oEntries.back());
+        oState.oIndex.erase(oState.oEntries.back().oKey);
+        oState.oEntries.pop_back();
+        oState.sStatistics.nEvictions++;
+    }
+
+    oState.oEntries.push_front(std::move(oEntry));
+    oState.oIndex[oKey] = oState.oEntries.begin();
+    oState.sStatistics.nBytes += nEntryBytes;
+}
+
+/************************************************************************/
+/*                           GetStatistics()                            */
+/************************************************************************/
+
+auto GRASSRowCache::GetStatistics() -> Statistics
+{
+    CacheState &oState = GetState();
+    std::lock_guard<std::mutex> oLock(oState.oMutex);
+    return oState.sStatistics;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+void GRASSRowCache::Clear()
+{
+    CacheState &oState = GetState();
+    std::lock_guard<std::mutex> oLock(oState.oMutex);
+    oState.oIndex.clear();
+    oState.oEntries.clear();
+    oState.sStatistics.nBytes = 0;
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Process wide cache of decoded GRASS raster rows.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSROWCACHE_H_INCLUDED
+#define GRASSROWCACHE_H_INCLUDED
+
+#include <string>
+
+#include "cpl_port.h"
+
+/************************************************************************/
+/*                            GRASSRowCache                             */
+/*                                                                      */
+/* Least recently used rows decoded by any band of any dataset, so that */
+/* datasets opening the same map in the same region share them. The     */
+/* memory budget is GRASS_ROW_CACHE_MB megabytes. Thread safe.          */
+/************************************************************************/
+class GRASSRowCache
+{
+  public:
+    /* A row of a map (with the modification time and size of its files,
+     * and the MASK applied to it) read in a region as CELL, FCELL or
+     * DCELL */
+    struct Key
+    {
+        std::string osMap{}; /* <gisdbase>/<location>/<mapset>/<name> */
+        GIntBig nMTime{-1};
+        GIntBig nSize{-1};
+        GIntBig nMaskMTime{-1}; /* -1 without MASK */
+        double dfNorth{0.0};
+        double dfSouth{0.0};
+        double dfEast{0.0};
+        double dfWest{0.0};
+        int nRows{0};
+        int nCols{0};
+        int nMapType{0};
+        int nRow{0};
+
+        auto operator==(const Key &oOther) const -> bool;
+    };
+
+    struct Statistics
+    {
+        GUIntBig nHits{0};
+        GUIntBig nMisses{0};
+        GUIntBig nEvictions{0};
+        size_t nBytes{0};
+    };
+
+    static auto IsEnabled() -> bool;
+    static auto Get(const Key &oKey, void *pRow, size_t nRowBytes) -> bool;
+    static void Put(const Key &oKey, const void *pRow, size_t nRowBytes);
+    static auto GetStatistics() -> Statistics;
+    static void Clear();
+};
+
+#endif /* ndef GRASSROWCACHE_H_INCLUDED */
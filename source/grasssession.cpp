@@ -0,0 +1,357 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Process wide state of the GRASS libraries, shared by the raster
+ *           and the vector driver.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "cpl_error.h"
+#include "cpl_vsi.h"
+#include "ogr_spatialref.h"
+
+#include "grasssession.h"
+
+extern "C"
+{
+#include <grass/raster.h>
+
+    auto GPJ_grass_to_wkt(const struct Key_Value *, const struct Key_Value *,
+                          int, int) -> char *;
+}
+
+namespace
+{
+
+/* Spatial reference of a location, with the modification times of the
+ * PROJ_* files it was built from (-1 for missing files) */
+struct SRSCacheEntry
+{
+    std::vector<GIntBig> anMTimes{};
+    OGRSpatialReference *poSRS{nullptr};
+};
+
+/* The state the GRASS libraries were last switched to by GRASSSession */
+struct SessionState
+{
+    std::recursive_mutex oMutex{};
+    bool bInitialized{false};
+
+    bool bHaveEnv{false};
+    std::string osGisdbase{};
+    std::string osLocation{};
+    std::string osMapset{};
+    std::vector<std::string> aosSearchPath{};
+
+    bool bHaveWindow{false};
+    struct Cell_head sWindow
+    {
+    };
+
+    std::vector<GRASSSession::LocationChangeHandler> apfnHandlers{};
+
+    GUIntBig nEnvSwitches{0};
+    GUIntBig nEnvSwitchesSkipped{0};
+
+    /* by GISDBASE/LOCATION_NAME, entries hold a reference to their SRS */
+    std::map<std::string, SRSCacheEntry> oSRSCache{};
+    GUIntBig nSRSCacheHits{0};
+};
+
+auto GetState() -> SessionState &
+{
+    static SessionState oState;
+    return oState;
+}
+
+/************************************************************************/
+/*                         Grass2CPLErrorHook()                         */
+/************************************************************************/
+
+auto Grass2CPLErrorHook(const char *pszMessage, int bFatal) -> int
+{
+    if (!bFatal)
+        CPLError(CE_Warning, CPLE_AppDefined, "GRASS warning: %s", pszMessage);
+    else
+        CPLError(CE_Warning, CPLE_AppDefined, "GRASS fatal error: %s",
+                 pszMessage);
+
+    return 0;
+}
+
+}  // namespace
+
+/************************************************************************/
+/*                              Acquire()                               */
+/*                                                                      */
+/* Lock serializing the use of the GRASS libraries. It is recursive, so */
+/* a thread holding it can call into code which acquires it again.     */
+/************************************************************************/
+
+auto GRASSSession::Acquire() -> Lock
+{
+    return Lock(GetState().oMutex);
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/*                                                                      */
+/* Initialize the GRASS libraries once per process. GISBASE must be set */
+/* in the environment before.                                           */
+/************************************************************************/
+
+auto GRASSSession::Init() -> bool
+{
+    auto oLock = Acquire();
+    SessionState &oState = GetState();
+
+    if (oState.bInitialized)
+        return true;
+
+    // Don't use GISRC file and read/write GRASS variables (from location
+    // G_VAR_GISRC) to memory only.
+    G_set_gisrc_mode(G_GISRC_MODE_MEMORY);
+
+    // Init GRASS libraries (required). G_no_gisinit() doesn't check write
+    // permissions for mapset compare to G_gisinit()
+    G_no_gisinit();
+
+    // Set error function
+    G_set_error_routine(Grass2CPLErrorHook);
+
+    oState.bInitialized = true;
+    return true;
+}
+
+/************************************************************************/
+/*                               SetEnv()                               */
+/*                                                                      */
+/* Make GISDBASE/LOCATION_NAME/MAPSET current, with only that mapset in */
+/* the search path. Nothing is done if that is already the case.        */
+/************************************************************************/
+
+void GRASSSession::SetEnv(const std::string &osGisdbase,
+                          const std::string &osLocation,
+                          const std::string &osMapset)
+{
+    auto oLock = Acquire();
+    SessionState &oState = GetState();
+
+    if (oState.bHaveEnv && oState.osGisdbase == osGisdbase &&
+        oState.osLocation == osLocation && oState.osMapset == osMapset &&
+        oState.aosSearchPath.size() == 1)
+    {
+        oState.nEnvSwitchesSkipped++;
+        return;
+    }
+
+    if (!oState.bHaveEnv || oState.osGisdbase != osGisdbase ||
+        oState.osLocation != osLocation)
+    {
+        // copy, handlers may unregister themselves
+        const auto apfnHandlers = oState.apfnHandlers;
+        for (auto pfnHandler : apfnHandlers)
+            pfnHandler(osGisdbase, osLocation);
+
+        // the window of another location is meaningless here
+        oState.bHaveWindow = false;
+    }
+
+    oState.nEnvSwitches++;
+
+    G_setenv_nogisrc("GISDBASE", osGisdbase.c_str());
+    G_setenv_nogisrc("LOCATION_NAME", osLocation.c_str());
+    G_setenv_nogisrc("MAPSET", osMapset.c_str());
+    G_reset_mapsets();
+    G_add_mapset_to_search_path(osMapset.c_str());
+
+    oState.bHaveEnv = true;
+    oState.osGisdbase = osGisdbase;
+    oState.osLocation = osLocation;
+    oState.osMapset = osMapset;
+    oState.aosSearchPath.assign(1, osMapset);
+}
+
+/************************************************************************/
+/*                        AddMapsetToSearchPath()                       */
+/************************************************************************/
+
+void GRASSSession::AddMapsetToSearchPath(const std::string &osMapset)
+{
+    auto oLock = Acquire();
+    SessionState &oState = GetState();
+
+    if (std::find(oState.aosSearchPath.begin(), oState.aosSearchPath.end(),
+                  osMapset) != oState.aosSearchPath.end())
+        return;
+
+    G_add_mapset_to_search_path(osMapset.c_str());
+    oState.aosSearchPath.push_back(osMapset);
+}
+
+/************************************************************************/
+/*                             SetWindow()                              */
+/*                                                                      */
+/* Set the raster window, unless it is the one set last in the current  */
+/* location. GRASS remaps all open rasters to the new window.           */
+/************************************************************************/
+
+void GRASSSession::SetWindow(const struct Cell_head *psWindow)
+{
+    auto oLock = Acquire();
+    SessionState &oState = GetState();
+    const struct Cell_head *psLast = &oState.sWindow;
+
+    if (oState.bHaveWindow && psLast->north == psWindow->north &&
+        psLast->south == psWindow->south && psLast->east == psWindow->east &&
+        psLast->west == psWindow->west && psLast->ew_res == psWindow->ew_res &&
+        psLast->ns_res == psWindow->ns_res && psLast->rows == psWindow->rows &&
+        psLast->cols == psWindow->cols && psLast->proj == psWindow->proj &&
+        psLast->zone == psWindow->zone)
+    {
+        return;
+    }
+
+    oState.sWindow = *psWindow;
+    Rast_set_window(&oState.sWindow);
+    oState.bHaveWindow = true;
+}
+
+/************************************************************************/
+/*                           GetSpatialRef()                            */
+/*                                                                      */
+/* Spatial reference of the current location (see SetEnv()), built     */
+/* once and shared by the datasets and layers of both drivers until a   */
+/* PROJ_* file of the location changes. The caller gets a reference it  */
+/* must Release(), nullptr without projection information.              */
+/************************************************************************/
+
+auto GRASSSession::GetSpatialRef() -> OGRSpatialReference *
+{
+    auto oLock = Acquire();
+    SessionState &oState = GetState();
+
+    if (!oState.bHaveEnv)
+        return nullptr;
+
+    const std::string osLocationPath =
+        oState.osGisdbase + "/" + oState.osLocation;
+    std::vector<GIntBig> anMTimes;
+    for (const char *pszFile :
+         {"PROJ_INFO", "PROJ_UNITS", "PROJ_EPSG", "PROJ_SRID", "PROJ_WKT"})
+    {
+        VSIStatBufL sStat;
+        const std::string osFile = osLocationPath + "/PERMANENT/" + pszFile;
+        anMTimes.push_back(VSIStatL(osFile.c_str(), &sStat) == 0
+                               ? static_cast<GIntBig>(sStat.st_mtime)
+                               : -1);
+    }
+
+    auto oIter = oState.oSRSCache.find(osLocationPath);
+    if (oIter != oState.oSRSCache.end() && oIter->second.anMTimes == anMTimes)
+    {
+        oState.nSRSCacheHits++;
+    }
+    else
+    {
+        SRSCacheEntry &oEntry = oState.oSRSCache[osLocationPath];
+        if (oEntry.poSRS != nullptr)
+            oEntry.poSRS->Release();
+        oEntry.poSRS = nullptr;
+        oEntry.anMTimes = anMTimes;
+
+        struct Key_Value *projinfo = G_get_projinfo();
+        struct Key_Value *projunits = G_get_projunits();
+
+        char *pszWKT = GPJ_grass_to_wkt(projinfo, projunits, 0, 0);
+        if (projinfo)
+            G_free_key_value(projinfo);
+        if (projunits)
+            G_free_key_value(projunits);
+        if (pszWKT)
+        {
+            auto poSRS = new OGRSpatialReference();
+            poSRS->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+            if (poSRS->importFromWkt(pszWKT) == OGRERR_NONE &&
+                !poSRS->IsEmpty())
+                oEntry.poSRS = poSRS;
+            else
+                poSRS->Release();
+        }
+        G_free(pszWKT);
+
+        oIter = oState.oSRSCache.find(osLocationPath);
+    }
+
+    OGRSpatialReference *poSRS = oIter->second.poSRS;
+    if (poSRS != nullptr)
+        poSRS->Reference();
+    return poSRS;
+}
+
+/************************************************************************/
+/*                      AddLocationChangeHandler()                      */
+/************************************************************************/
+
+void GRASSSession::AddLocationChangeHandler(LocationChangeHandler pfnHandler)
+{
+    auto oLock = Acquire();
+    auto &apfnHandlers = GetState().apfnHandlers;
+
+    if (std::find(apfnHandlers.begin(), apfnHandlers.end(), pfnHandler) ==
+        apfnHandlers.end())
+        apfnHandlers.push_back(pfnHandler);
+}
+
+/************************************************************************/
+/*                    RemoveLocationChangeHandler()                     */
+/************************************************************************/
+
+void GRASSSession::RemoveLocationChangeHandler(LocationChangeHandler pfnHandler)
+{
+    auto oLock = Acquire();
+    auto &apfnHandlers = GetState().apfnHandlers;
+
+    apfnHandlers.erase(
+        std::remove(apfnHandlers.begin(), apfnHandlers.end(), pfnHandler),
+        apfnHandlers.end());
+}
+
+/************************************************************************/
+/*                           GetEnvSwitches()                           */
+/************************************************************************/
+
+auto GRASSSession::GetEnvSwitches() -> GUIntBig
+{
+    auto oLock = Acquire();
+    return GetState().nEnvSwitches;
+}
+
+/************************************************************************/
+/*                        GetEnvSwitchesSkipped()                       */
+/************************************************************************/
+
+auto GRASSSession::GetEnvSwitchesSkipped() -> GUIntBig
+{
+    auto oLock = Acquire();
+    return GetState().nEnvSwitchesSkipped;
+}
+
+/************************************************************************/
+/*                          GetSRSCacheHits()                           */
+/************************************************************************/
+
+auto GRASSSession::GetSRSCacheHits() -> GUIntBig
+{
+    auto oLock = Acquire();
+    return GetState().nSRSCacheHits;
+}
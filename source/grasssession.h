@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Process wide state of the GRASS libraries, shared by the raster
+ *           and the vector driver.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSSESSION_H_INCLUDED
+#define GRASSSESSION_H_INCLUDED
+
+#include <mutex>
+#include <string>
+
+#include "cpl_port.h"
+
+class OGRSpatialReference;
+
+extern "C"
+{
+#include <grass/gis.h>
+}
+
+#if defined(_WIN32) && defined(GRASS_SESSION_EXPORTS)
+#define GRASS_SESSION_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define GRASS_SESSION_API __declspec(dllimport)
+#else
+#define GRASS_SESSION_API
+#endif
+
+/************************************************************************/
+/*                             GRASSSession                             */
+/*                                                                      */
+/* The GRASS libraries keep GISDBASE, LOCATION_NAME, MAPSET, the mapset */
+/* search path and the raster window in process global variables. Both  */
+/* drivers link this library so that there is a single record of that   */
+/* state and a single lock in the process: switches to the state which  */
+/* is already active are skipped, and all calls into the GRASS          */
+/* libraries are expected to be made while holding Acquire().           */
+/************************************************************************/
+class GRASS_SESSION_API GRASSSession
+{
+  public:
+    using Lock = std::unique_lock<std::recursive_mutex>;
+
+    /* Called before another GISDBASE/LOCATION_NAME is activated, with the
+     * new GISDBASE and LOCATION_NAME. */
+    using LocationChangeHandler = void (*)(const std::string &,
+                                           const std::string &);
+
+    static auto Acquire() -> Lock;
+
+    static auto Init() -> bool;
+
+    static void SetEnv(const std::string &osGisdbase,
+                       const std::string &osLocation,
+                       const std::string &osMapset);
+    static void AddMapsetToSearchPath(const std::string &osMapset);
+    static void SetWindow(const struct Cell_head *psWindow);
+
+    static auto GetSpatialRef() -> OGRSpatialReference *;
+
+    static void AddLocationChangeHandler(LocationChangeHandler pfnHandler);
+    static void RemoveLocationChangeHandler(LocationChangeHandler pfnHandler);
+
+    static auto GetEnvSwitches() -> GUIntBig;
+    static auto GetEnvSwitchesSkipped() -> GUIntBig;
+    static auto GetSRSCacheHits() -> GUIntBig;
+};
+
+#endif /* ndef GRASSSESSION_H_INCLUDED */
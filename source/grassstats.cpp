@@ -0,0 +1,203 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Statistics and histograms accumulated over decoded GRASS
+ *           raster rows.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+extern "C"
+{
+#include <grass/gis.h>
+}
+
+#include "grassstats.h"
+
+/* CELL null value, see Rast_set_c_null_value() */
+static constexpr CELL CELL_NULL = std::numeric_limits<CELL>::min();
+
+/************************************************************************/
+/*                            IsNullCell()                              */
+/*                                                                      */
+/* FCELL and DCELL nulls are NaN, NaN values are left out like GDAL     */
+/* does.                                                                */
+/************************************************************************/
+
+static inline auto IsNullCell(CELL nValue) -> bool
+{
+    return nValue == CELL_NULL;
+}
+
+static inline auto IsNullCell(FCELL fValue) -> bool
+{
+    return std::isnan(fValue);
+}
+
+static inline auto IsNullCell(DCELL dfValue) -> bool
+{
+    return std::isnan(dfValue);
+}
+
+/************************************************************************/
+/*                            SetHistogram()                            */
+/************************************************************************/
+
+void GRASSRowStatistics::SetHistogram(double dfMinIn, double dfMaxIn,
+                                      int nBuckets, bool bIncludeOutOfRangeIn)
+{
+    dfHistMin = dfMinIn;
+    dfHistMax = dfMaxIn;
+    bIncludeOutOfRange = bIncludeOutOfRangeIn;
+    anHistogram.assign(nBuckets, 0);
+}
+
+/************************************************************************/
+/*                              AddCells()                              */
+/*                                                                      */
+/* The moments of the row are computed in two passes over the values    */
+/* gathered in adfValues, then merged.                                  */
+/************************************************************************/
+
+template <class T>
+void GRASSRowStatistics::AddCells(const T *pCells, int nCols)
+{
+    adfValues.clear();
+    for (int i = 0; i < nCols; i++)
+    {
+        if (!IsNullCell(pCells[i]))
+            adfValues.push_back(static_cast<double>(pCells[i]));
+    }
+    if (adfValues.empty())
+        return;
+
+    double dfRowMin = adfValues[0];
+    double dfRowMax = adfValues[0];
+    double dfSum = 0.0;
+    for (const double dfValue : adfValues)
+    {
+        dfRowMin = std::min(dfRowMin, dfValue);
+        dfRowMax = std::max(dfRowMax, dfValue);
+        dfSum += dfValue;
+    }
+
+    const double dfRowMean = dfSum / adfValues.size();
+    double dfRowM2 = 0.0;
+    for (const double dfValue : adfValues)
+        dfRowM2 += (dfValue - dfRowMean) * (dfValue - dfRowMean);
+
+    if (nCount == 0)
+    {
+        dfMin = dfRowMin;
+        dfMax = dfRowMax;
+    }
+    else
+    {
+        dfMin = std::min(dfMin, dfRowMin);
+        dfMax = std::max(dfMax, dfRowMax);
+    }
+    AddMoments(adfValues.size(), dfRowMean, dfRowM2);
+
+    if (anHistogram.empty())
+        return;
+
+    const int nBuckets = static_cast<int>(anHistogram.size());
+    const double dfScale = nBuckets / (dfHistMax - dfHistMin);
+    for (const double dfValue : adfValues)
+    {
+        const double dfIndex = std::floor((dfValue - dfHistMin) * dfScale);
+        int nIndex = 0;
+        if (dfIndex < 0)
+        {
+            if (!bIncludeOutOfRange)
+                continue;
+        }
+        else if (dfIndex >= nBuckets)
+        {
+            if (!bIncludeOutOfRange)
+                continue;
+            nIndex = nBuckets - 1;
+        }
+        else
+        {
+            nIndex = static_cast<int>(dfIndex);
+        }
+        anHistogram[nIndex]++;
+    }
+}
+
+/************************************************************************/
+/*                               AddRow()                               */
+/************************************************************************/
+
+void GRASSRowStatistics::AddRow(const void *pRow, int nMapType, int nCols)
+{
+    if (nMapType == CELL_TYPE)
+        AddCells(static_cast<const CELL *>(pRow), nCols);
+    else if (nMapType == FCELL_TYPE)
+        AddCells(static_cast<const FCELL *>(pRow), nCols);
+    else
+        AddCells(static_cast<const DCELL *>(pRow), nCols);
+}
+
+/************************************************************************/
+/*                             AddMoments()                             */
+/************************************************************************/
+
+void GRASSRowStatistics::AddMoments(GUIntBig nOtherCount, double dfOtherMean,
+                                    double dfOtherM2)
+{
+    const double dfCount = static_cast<double>(nCount);
+    const double dfOtherCount = static_cast<double>(nOtherCount);
+    const double dfTotal = dfCount + dfOtherCount;
+    const double dfDelta = dfOtherMean - dfMean;
+
+    dfMean += dfDelta * dfOtherCount / dfTotal;
+    dfM2 += dfOtherM2 + dfDelta * dfDelta * dfCount * dfOtherCount / dfTotal;
+    nCount += nOtherCount;
+}
+
+/************************************************************************/
+/*                               Merge()                                */
+/************************************************************************/
+
+void GRASSRowStatistics::Merge(const GRASSRowStatistics &oOther)
+{
+    if (oOther.nCount > 0)
+    {
+        if (nCount == 0)
+        {
+            dfMin = oOther.dfMin;
+            dfMax = oOther.dfMax;
+        }
+        else
+        {
+            dfMin = std::min(dfMin, oOther.dfMin);
+            dfMax = std::max(dfMax, oOther.dfMax);
+        }
+        AddMoments(oOther.nCount, oOther.dfMean, oOther.dfM2);
+    }
+
+    for (size_t i = 0;
+         i < anHistogram.size() && i < oOther.anHistogram.size(); i++)
+        anHistogram[i] += oOther.anHistogram[i];
+}
+
+/************************************************************************/
+/*                             GetStdDev()                              */
+/*                                                                      */
+/* Population standard deviation, as computed by GDAL.                  */
+/************************************************************************/
+
+auto GRASSRowStatistics::GetStdDev() const -> double
+{
+    return nCount > 0 ? std::sqrt(dfM2 / static_cast<double>(nCount)) : 0.0;
+}
@@ -0,0 +1,62 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Statistics and histograms accumulated over decoded GRASS
+ *           raster rows.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSSTATS_H_INCLUDED
+#define GRASSSTATS_H_INCLUDED
+
+#include <vector>
+
+#include "cpl_port.h"
+
+/************************************************************************/
+/*                          GRASSRowStatistics                          */
+/*                                                                      */
+/* Count, extrema, mean and sum of squared deviations of the non null   */
+/* cells of rows read as CELL, FCELL or DCELL, and optionally their     */
+/* histogram with the bucketing of GDALRasterBand::GetHistogram().      */
+/* Row ranges are accumulated separately and merged, the moments with   */
+/* the pairwise formula of Chan et al.                                  */
+/************************************************************************/
+class GRASSRowStatistics
+{
+  public:
+    GRASSRowStatistics() = default;
+
+    void SetHistogram(double dfMin, double dfMax, int nBuckets,
+                      bool bIncludeOutOfRange);
+
+    void AddRow(const void *pRow, int nMapType, int nCols);
+    void Merge(const GRASSRowStatistics &oOther);
+
+    auto GetStdDev() const -> double;
+
+    GUIntBig nCount{0};
+    double dfMin{0.0};
+    double dfMax{0.0};
+    double dfMean{0.0};
+    double dfM2{0.0}; /* sum of squared deviations from the mean */
+
+    std::vector<GUIntBig> anHistogram{};
+
+  private:
+    template <class T> void AddCells(const T *pCells, int nCols);
+    void AddMoments(GUIntBig nOtherCount, double dfOtherMean,
+                    double dfOtherM2);
+
+    double dfHistMin{0.0};
+    double dfHistMax{0.0};
+    bool bIncludeOutOfRange{false};
+    std::vector<double> adfValues{};
+};
+
+#endif /* ndef GRASSSTATS_H_INCLUDED */
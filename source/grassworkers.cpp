@@ -0,0 +1,586 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Pool of worker processes decoding GRASS raster rows in
+ *           parallel, each with its own GRASS library state.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+
+#include "grassworkers.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include <grass/raster.h>
+}
+#endif
+
+enum
+{
+    GRASS_WORKER_SLOT_BYTES = 4 * 1024 * 1024,
+    GRASS_WORKER_SLOTS = 2,
+    GRASS_WORKER_MAX = 256,
+    GRASS_WORKER_MIN_ROWS = 8 /* rows per worker worth a request */
+};
+
+static GRASSWorkerPool *poWorkerPool = nullptr;
+static bool bWorkerPoolTried = false;
+static std::mutex oWorkerPoolMutex;
+
+#ifndef _WIN32
+
+/* Messages sent by the parent */
+enum
+{
+    GRASS_WORKER_READ = 1,   /* followed by the 4 strings */
+    GRASS_WORKER_CREDIT = 2, /* a slot was consumed */
+};
+
+struct WorkerMessage
+{
+    int nType;
+    int nMapType;
+    int nFirstRow;
+    int nRows;
+    struct Cell_head sWindow;
+    int anLengths[4]; /* gisdbase, location, mapset, name */
+};
+
+/* Replies of the workers */
+enum
+{
+    GRASS_WORKER_ROWS = 0, /* rows written to a slot */
+    GRASS_WORKER_DONE = 1,
+    GRASS_WORKER_ERROR = -1
+};
+
+struct WorkerReply
+{
+    int nStatus;
+    int nSlot;
+    int nFirstRow;
+    int nRows;
+};
+
+/************************************************************************/
+/*                             SendAll()                                */
+/************************************************************************/
+
+static auto SendAll(int nSocket, const void *pData, size_t nSize) -> bool
+{
+    const char *pabyData = static_cast<const char *>(pData);
+    while (nSize > 0)
+    {
+        const ssize_t nSent = send(nSocket, pabyData, nSize, MSG_NOSIGNAL);
+        if (nSent < 0 && errno == EINTR)
+            continue;
+        if (nSent <= 0)
+            return false;
+        pabyData += nSent;
+        nSize -= static_cast<size_t>(nSent);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            ReceiveAll()                              */
+/************************************************************************/
+
+static auto ReceiveAll(int nSocket, void *pData, size_t nSize) -> bool
+{
+    char *pabyData = static_cast<char *>(pData);
+    while (nSize > 0)
+    {
+        const ssize_t nReceived = recv(nSocket, pabyData, nSize, 0);
+        if (nReceived < 0 && errno == EINTR)
+            continue;
+        if (nReceived <= 0)
+            return false;
+        pabyData += nReceived;
+        nSize -= static_cast<size_t>(nReceived);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            RowBytes()                                */
+/************************************************************************/
+
+static auto RowBytes(int nMapType, int nCols) -> size_t
+{
+    return static_cast<size_t>(nCols) *
+           (nMapType == DCELL_TYPE ? sizeof(DCELL) : sizeof(CELL));
+}
+
+/************************************************************************/
+/*                          WorkerErrorHook()                           */
+/*                                                                      */
+/* Workers must not use GDAL (its locks may have been held by other     */
+/* threads at fork time) nor run exit handlers: leave on fatal errors,  */
+/* the parent sees the closed socket.                                   */
+/************************************************************************/
+
+static auto WorkerErrorHook(const char *, int bFatal) -> int
+{
+    if (bFatal)
+        _exit(EXIT_FAILURE);
+    return 0;
+}
+
+/************************************************************************/
+/*                             WorkerMain()                             */
+/*                                                                      */
+/* Serve read requests until the parent closes the socket.              */
+/************************************************************************/
+
+static void WorkerMain(int nSocket, GByte *pabySlots)
+{
+    G_set_error_routine(WorkerErrorHook);
+
+    std::string osGisdbase, osLocation, osMapset;
+    std::string osOpenName, osOpenMapset;
+    int hCell = -1;
+    bool bHaveWindow = false;
+    struct Cell_head sCurrentWindow
+    {
+    };
+
+    while (true)
+    {
+        WorkerMessage sMessage;
+        if (!ReceiveAll(nSocket, &sMessage, sizeof(sMessage)))
+            break;
+        // credits left from the previous request
+        if (sMessage.nType != GRASS_WORKER_READ)
+            continue;
+
+        std::string aosStrings[4];
+        bool bOK = true;
+        for (int i = 0; i < 4 && bOK; i++)
+        {
+            aosStrings[i].resize(sMessage.anLengths[i]);
+            bOK = ReceiveAll(nSocket, &aosStrings[i][0], aosStrings[i].size());
+        }
+        if (!bOK)
+            break;
+
+        /* ---------------------------------------------------------------- */
+        /*      Switch the GRASS state of this process if needed.           */
+        /* ---------------------------------------------------------------- */
+        if (aosStrings[0] != osGisdbase || aosStrings[1] != osLocation ||
+            aosStrings[2] != osMapset)
+        {
+            if (hCell >= 0 &&
+                (aosStrings[0] != osGisdbase || aosStrings[1] != osLocation))
+            {
+                Rast_close(hCell);
+                hCell = -1;
+                osOpenName.clear();
+                bHaveWindow = false;
+            }
+            osGisdbase = aosStrings[0];
+            osLocation = aosStrings[1];
+            osMapset = aosStrings[2];
+            G_setenv_nogisrc("GISDBASE", osGisdbase.c_str());
+            G_setenv_nogisrc("LOCATION_NAME", osLocation.c_str());
+            G_setenv_nogisrc("MAPSET", osMapset.c_str());
+            G_reset_mapsets();
+            G_add_mapset_to_search_path(osMapset.c_str());
+        }
+
+        if (!bHaveWindow ||
+            memcmp(&sCurrentWindow, &sMessage.sWindow, sizeof(sCurrentWindow)))
+        {
+            sCurrentWindow = sMessage.sWindow;
+            Rast_set_window(&sCurrentWindow);
+            bHaveWindow = true;
+        }
+
+        if (hCell < 0 || aosStrings[3] != osOpenName ||
+            osMapset != osOpenMapset)
+        {
+            if (hCell >= 0)
+                Rast_close(hCell);
+            hCell = Rast_open_old(aosStrings[3].c_str(), osMapset.c_str());
+            osOpenName = aosStrings[3];
+            osOpenMapset = osMapset;
+        }
+
+        /* ---------------------------------------------------------------- */
+        /*      Decode the rows, alternating between the two slots.         */
+        /* ---------------------------------------------------------------- */
+        const size_t nRowBytes =
+            RowBytes(sMessage.nMapType, sCurrentWindow.cols);
+        const int nRowsPerSlot =
+            static_cast<int>(GRASS_WORKER_SLOT_BYTES / nRowBytes);
+        int nCredits = GRASS_WORKER_SLOTS;
+        int nSlot = 0;
+        const int nEndRow = sMessage.nFirstRow + sMessage.nRows;
+
+        for (int nRow = sMessage.nFirstRow; nRow < nEndRow && bOK;)
+        {
+            while (nCredits == 0 && bOK)
+            {
+                WorkerMessage sCredit;
+                bOK = ReceiveAll(nSocket, &sCredit, sizeof(sCredit)) &&
+                      sCredit.nType == GRASS_WORKER_CREDIT;
+                nCredits++;
+            }
+            if (!bOK)
+                break;
+
+            const int nChunkRows = std::min(nRowsPerSlot, nEndRow - nRow);
+            GByte *pabySlot =
+                pabySlots + static_cast<size_t>(nSlot) * GRASS_WORKER_SLOT_BYTES;
+            for (int i = 0; i < nChunkRows; i++)
+            {
+                void *pRow = pabySlot + i * nRowBytes;
+                if (sMessage.nMapType == CELL_TYPE)
+                    Rast_get_c_row(hCell, static_cast<CELL *>(pRow), nRow + i);
+                else if (sMessage.nMapType == FCELL_TYPE)
+                    Rast_get_f_row(hCell, static_cast<FCELL *>(pRow), nRow + i);
+                else
+                    Rast_get_d_row(hCell, static_cast<DCELL *>(pRow), nRow + i);
+            }
+
+            const WorkerReply sReply = {GRASS_WORKER_ROWS, nSlot, nRow,
+                                        nChunkRows};
+            bOK = SendAll(nSocket, &sReply, sizeof(sReply));
+            nCredits--;
+            nSlot = (nSlot + 1) % GRASS_WORKER_SLOTS;
+            nRow += nChunkRows;
+        }
+        if (!bOK)
+            break;
+
+        const WorkerReply sDone = {GRASS_WORKER_DONE, 0, 0, 0};
+        if (!SendAll(nSocket, &sDone, sizeof(sDone)))
+            break;
+    }
+
+    _exit(0);
+}
+
+#endif /* ndef _WIN32 */
+
+/************************************************************************/
+/*                           ~GRASSWorkerPool()                         */
+/************************************************************************/
+
+GRASSWorkerPool::~GRASSWorkerPool()
+{
+    Stop();
+}
+
+/************************************************************************/
+/*                               Start()                                */
+/************************************************************************/
+
+auto GRASSWorkerPool::Start(int nWorkers) -> bool
+{
+#ifdef _WIN32
+    (void)nWorkers;
+    return false;
+#else
+    const size_t nShmSize =
+        static_cast<size_t>(GRASS_WORKER_SLOTS) * GRASS_WORKER_SLOT_BYTES;
+
+    for (int iWorker = 0; iWorker < nWorkers; iWorker++)
+    {
+        int anSockets[2] = {-1, -1};
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, anSockets) != 0)
+            break;
+
+        void *pShm = mmap(nullptr, nShmSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (pShm == MAP_FAILED)
+        {
+            close(anSockets[0]);
+            close(anSockets[1]);
+            break;
+        }
+
+        const pid_t nPid = fork();
+        if (nPid == 0)
+        {
+            // the other workers must see EOF when the parent closes them
+            for (const auto &oWorker : aoWorkers)
+                close(oWorker.nSocket);
+            close(anSockets[0]);
+            WorkerMain(anSockets[1], static_cast<GByte *>(pShm));
+        }
+
+        close(anSockets[1]);
+        if (nPid < 0)
+        {
+            close(anSockets[0]);
+            munmap(pShm, nShmSize);
+            break;
+        }
+
+        Worker oWorker;
+        oWorker.nPid = static_cast<int>(nPid);
+        oWorker.nSocket = anSockets[0];
+        oWorker.pabySlots = static_cast<GByte *>(pShm);
+        aoWorkers.push_back(oWorker);
+    }
+
+    CPLDebug("GRASS", "Started %d worker processes of %d",
+             static_cast<int>(aoWorkers.size()), nWorkers);
+
+    return aoWorkers.size() > 1;
+#endif
+}
+
+/************************************************************************/
+/*                               Stop()                                 */
+/************************************************************************/
+
+void GRASSWorkerPool::Stop()
+{
+#ifndef _WIN32
+    for (const auto &oWorker : aoWorkers)
+        close(oWorker.nSocket);
+    for (const auto &oWorker : aoWorkers)
+    {
+        waitpid(oWorker.nPid, nullptr, 0);
+        munmap(oWorker.pabySlots,
+               static_cast<size_t>(GRASS_WORKER_SLOTS) *
+                   GRASS_WORKER_SLOT_BYTES);
+    }
+#endif
+    aoWorkers.clear();
+}
+
+/************************************************************************/
+/*                             IsRunning()                              */
+/************************************************************************/
+
+auto GRASSWorkerPool::IsRunning() -> bool
+{
+    std::lock_guard<std::mutex> oLock(oWorkerPoolMutex);
+    return poWorkerPool != nullptr;
+}
+
+/************************************************************************/
+/*                                Get()                                 */
+/*                                                                      */
+/* The pool of the process, started on first use with GDAL_NUM_THREADS  */
+/* workers (all CPUs if not set). nullptr if it cannot be started.      */
+/************************************************************************/
+
+auto GRASSWorkerPool::Get() -> GRASSWorkerPool *
+{
+    std::lock_guard<std::mutex> oLock(oWorkerPoolMutex);
+
+    if (poWorkerPool != nullptr || bWorkerPoolTried)
+        return poWorkerPool;
+    bWorkerPoolTried = true;
+
+    const char *pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    int nWorkers = CPLGetNumCPUs();
+    if (pszThreads != nullptr && !EQUAL(pszThreads, "ALL_CPUS"))
+        nWorkers = atoi(pszThreads);
+    nWorkers = std::min(nWorkers, static_cast<int>(GRASS_WORKER_MAX));
+    if (nWorkers < 2)
+    {
+        CPLDebug("GRASS", "GDAL_NUM_THREADS < 2, not using worker processes");
+        return nullptr;
+    }
+
+    auto poPool = new GRASSWorkerPool();
+    if (!poPool->Start(nWorkers))
+    {
+        delete poPool;
+        return nullptr;
+    }
+
+    poWorkerPool = poPool;
+    return poWorkerPool;
+}
+
+/************************************************************************/
+/*                              Shutdown()                              */
+/************************************************************************/
+
+void GRASSWorkerPool::Shutdown()
+{
+    std::lock_guard<std::mutex> oLock(oWorkerPoolMutex);
+    delete poWorkerPool;
+    poWorkerPool = nullptr;
+    bWorkerPoolTried = false;
+}
+
+/************************************************************************/
+/*                              CanRead()                               */
+/*                                                                      */
+/* Whether a row of nCols cells of the map type fits in a slot.         */
+/************************************************************************/
+
+auto GRASSWorkerPool::CanRead(int nMapType, int nCols) -> bool
+{
+#ifdef _WIN32
+    (void)nMapType;
+    (void)nCols;
+    return false;
+#else
+    const size_t nRowBytes = RowBytes(nMapType, nCols);
+    return nRowBytes > 0 && nRowBytes <= GRASS_WORKER_SLOT_BYTES;
+#endif
+}
+
+/************************************************************************/
+/*                              ReadRows()                              */
+/*                                                                      */
+/* Read nRows rows of oRequest.sWindow from nFirstRow, spread over the  */
+/* workers, and pass them to pfnHandler in the order they arrive. The   */
+/* request must pass CanRead(). Returns false on failure, after which   */
+/* the pool is stopped.                                                 */
+/************************************************************************/
+
+auto GRASSWorkerPool::ReadRows(const Request &oRequest, int nFirstRow,
+                               int nRows, const RowHandler &pfnHandler) -> bool
+{
+#ifdef _WIN32
+    (void)oRequest;
+    (void)nFirstRow;
+    (void)nRows;
+    (void)pfnHandler;
+    return false;
+#else
+    std::lock_guard<std::mutex> oLock(oMutex);
+
+    const size_t nRowBytes =
+        RowBytes(oRequest.nMapType, oRequest.sWindow.cols);
+    if (aoWorkers.empty() ||
+        !CanRead(oRequest.nMapType, oRequest.sWindow.cols))
+        return false;
+    if (nRows < 1)
+        return true;
+
+    /* -------------------------------------------------------------------- */
+    /*      Send a row range to each worker.                                */
+    /* -------------------------------------------------------------------- */
+    const int nWorkers = static_cast<int>(aoWorkers.size());
+    const int nRowsPerWorker =
+        std::max(static_cast<int>(GRASS_WORKER_MIN_ROWS),
+                 (nRows + nWorkers - 1) / nWorkers);
+    const std::string *apoStrings[4] = {&oRequest.osGisdbase,
+                                        &oRequest.osLocation,
+                                        &oRequest.osMapset, &oRequest.osName};
+    std::vector<int> anBusy;
+    bool bOK = true;
+
+    for (int iWorker = 0; iWorker < nWorkers && bOK; iWorker++)
+    {
+        const int nStart = nFirstRow + iWorker * nRowsPerWorker;
+        const int nCount =
+            std::min(nRowsPerWorker, nFirstRow + nRows - nStart);
+        if (nCount <= 0)
+            break;
+
+        WorkerMessage sMessage;
+        memset(&sMessage, 0, sizeof(sMessage));
+        sMessage.nType = GRASS_WORKER_READ;
+        sMessage.nMapType = oRequest.nMapType;
+        sMessage.nFirstRow = nStart;
+        sMessage.nRows = nCount;
+        sMessage.sWindow = oRequest.sWindow;
+        for (int i = 0; i < 4; i++)
+            sMessage.anLengths[i] = static_cast<int>(apoStrings[i]->size());
+
+        const int nSocket = aoWorkers[iWorker].nSocket;
+        bOK = SendAll(nSocket, &sMessage, sizeof(sMessage));
+        for (int i = 0; i < 4 && bOK; i++)
+            bOK = SendAll(nSocket, apoStrings[i]->data(), apoStrings[i]->size());
+        anBusy.push_back(iWorker);
+    }
+
+    /* -------------------------------------------------------------------- */
+    /*      Consume the slots as they are filled.                           */
+    /* -------------------------------------------------------------------- */
+    std::vector<struct pollfd> asPollFds;
+    while (bOK && !anBusy.empty())
+    {
+        asPollFds.resize(anBusy.size());
+        for (size_t i = 0; i < anBusy.size(); i++)
+        {
+            asPollFds[i].fd = aoWorkers[anBusy[i]].nSocket;
+            asPollFds[i].events = POLLIN;
+            asPollFds[i].revents = 0;
+        }
+        if (poll(asPollFds.data(), asPollFds.size(), -1) < 0)
+        {
+            bOK = errno == EINTR;
+            continue;
+        }
+
+        for (size_t i = 0; i < asPollFds.size() && bOK; i++)
+        {
+            if (asPollFds[i].revents == 0)
+                continue;
+
+            const Worker &oWorker = aoWorkers[anBusy[i]];
+            WorkerReply sReply;
+            bOK = ReceiveAll(oWorker.nSocket, &sReply, sizeof(sReply)) &&
+                  sReply.nStatus != GRASS_WORKER_ERROR;
+            if (!bOK)
+                break;
+
+            if (sReply.nStatus == GRASS_WORKER_DONE)
+            {
+                anBusy[i] = -1;
+                continue;
+            }
+
+            GByte *pabySlot =
+                oWorker.pabySlots +
+                static_cast<size_t>(sReply.nSlot) * GRASS_WORKER_SLOT_BYTES;
+            for (int iRow = 0; iRow < sReply.nRows; iRow++)
+                pfnHandler(sReply.nFirstRow + iRow, pabySlot + iRow * nRowBytes);
+
+            WorkerMessage sCredit;
+            memset(&sCredit, 0, sizeof(sCredit));
+            sCredit.nType = GRASS_WORKER_CREDIT;
+            bOK = SendAll(oWorker.nSocket, &sCredit, sizeof(sCredit));
+        }
+
+        anBusy.erase(std::remove(anBusy.begin(), anBusy.end(), -1),
+                     anBusy.end());
+    }
+
+    if (!bOK)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "GRASS: Worker process failed reading %s@%s, stopping the "
+                 "worker processes",
+                 oRequest.osName.c_str(), oRequest.osMapset.c_str());
+        for (const auto &oWorker : aoWorkers)
+            kill(oWorker.nPid, SIGKILL);
+        Stop();
+    }
+
+    return bOK;
+#endif
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+ *
+ * Project:  GRASS Driver
+ * Purpose:  Pool of worker processes decoding GRASS raster rows in
+ *           parallel, each with its own GRASS library state.
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, GDAL-GRASS contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ ****************************************************************************/
+
+#ifndef GRASSWORKERS_H_INCLUDED
+#define GRASSWORKERS_H_INCLUDED
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cpl_port.h"
+
+extern "C"
+{
+#include <grass/gis.h>
+}
+
+/************************************************************************/
+/*                           GRASSWorkerPool                            */
+/*                                                                      */
+/* The GRASS libraries are not thread safe, so rows are decoded in      */
+/* forked processes instead. A read request is split into row ranges,   */
+/* one per worker; each worker returns its rows through a shared memory */
+/* ring of two slots while the parent consumes the other one.           */
+/*                                                                      */
+/* Workers inherit the GRASS state of the parent at fork time, so the   */
+/* pool must be started while holding the GRASSSession lock and without */
+/* open GRASS rasters. Not available on Windows.                        */
+/************************************************************************/
+class GRASSWorkerPool
+{
+  public:
+    struct Request
+    {
+        std::string osGisdbase{};
+        std::string osLocation{};
+        std::string osMapset{};
+        std::string osName{};
+        int nMapType{CELL_TYPE};
+        struct Cell_head sWindow
+        {
+        };
+    };
+
+    /* Called in the parent for each row read, with the row number in the
+     * window and the row as CELL, FCELL or DCELL (the map type). The row
+     * may be modified in place. */
+    using RowHandler = std::function<void(int, void *)>;
+
+    static auto IsRunning() -> bool;
+    static auto Get() -> GRASSWorkerPool *;
+    static void Shutdown();
+
+    auto GetWorkerCount() const -> int
+    {
+        return static_cast<int>(aoWorkers.size());
+    }
+
+    static auto CanRead(int nMapType, int nCols) -> bool;
+    auto ReadRows(const Request &oRequest, int nFirstRow, int nRows,
+                  const RowHandler &pfnHandler) -> bool;
+
+  private:
+    struct Worker
+    {
+        int nPid{-1};
+        int nSocket{-1};       /* parent end of the socket pair */
+        GByte *pabySlots{nullptr}; /* shared memory, two slots */
+    };
+
+    GRASSWorkerPool() = default;
+    ~GRASSWorkerPool();
+
+    auto Start(int nWorkers) -> bool;
+    void Stop();
+
+    std::mutex oMutex{};
+    std::vector<Worker> aoWorkers{};
+};
+
+#endif /* ndef GRASSWORKERS_H_INCLUDED */
@@ -17,6 +17,8 @@
 #include "gdal_version.h"
 #include "ogrsf_frmts.h"
 
+#include "grasssession.h"
+
 extern "C"
 {
 #include <grass/version.h>
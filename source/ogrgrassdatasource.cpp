@@ -19,25 +19,13 @@
 #include "cpl_conv.h"
 #include "cpl_string.h"
 
-/************************************************************************/
-/*                         Grass2CPLErrorHook()                         */
-/************************************************************************/
-static auto Grass2CPLErrorHook(char *pszMessage, int bFatal) -> int
-{
-    if (!bFatal)
-        CPLError(CE_Warning, CPLE_AppDefined, "GRASS warning: %s", pszMessage);
-    else
-        CPLError(CE_Warning, CPLE_AppDefined, "GRASS fatal error: %s",
-                 pszMessage);
-
-    return 0;
-}
-
 /************************************************************************/
 /*                        ~OGRGRASSDataSource()                         */
 /************************************************************************/
 OGRGRASSDataSource::~OGRGRASSDataSource()
 {
+    auto oLock = GRASSSession::Acquire();
+
     for (int i = 0; i < nLayers; i++)
         delete papoLayers[i];
 
@@ -49,8 +37,6 @@ OGRGRASSDataSource::~OGRGRASSDataSource()
 /*                                Open()                                */
 /************************************************************************/
 
-using GrassErrorHandler = auto(*)(const char *, int) -> int;
-
 auto OGRGRASSDataSource::Open(const char *pszNewName, bool /*bUpdate*/,
                               bool bTestOpen, bool /*bSingleNewFileIn*/) -> bool
 {
@@ -108,6 +94,8 @@ auto OGRGRASSDataSource::Open(const char *pszNewName, bool /*bUpdate*/,
     /* -------------------------------------------------------------------- */
     /*      Init GRASS library                                              */
     /* -------------------------------------------------------------------- */
+    auto oLock = GRASSSession::Acquire();
+
     // GISBASE is path to the directory where GRASS is installed,
     // it is necessary because there are database drivers.
     if (!getenv("GISBASE"))
@@ -126,25 +114,13 @@ auto OGRGRASSDataSource::Open(const char *pszNewName, bool /*bUpdate*/,
         putenv(gisbaseEnv);
     }
 
-    // Don't use GISRC file and read/write GRASS variables
-    // (from location G_VAR_GISRC) to memory only.
-    G_set_gisrc_mode(G_GISRC_MODE_MEMORY);
-
-    // Init GRASS libraries (required). G_no_gisinit() doesn't check
-    // write permissions for mapset compare to G_gisinit()
-    G_no_gisinit();
-
-    // Set error function
-    G_set_error_routine(GrassErrorHandler(Grass2CPLErrorHook));
+    // Init GRASS libraries (required), once per process
+    GRASSSession::Init();
 
     /* -------------------------------------------------------------------- */
     /*      Set GRASS variables                                             */
     /* -------------------------------------------------------------------- */
-    G_setenv_nogisrc("GISDBASE", osGisdbase.c_str());
-    G_setenv_nogisrc("LOCATION_NAME", osLocation.c_str());
-    G_setenv_nogisrc("MAPSET", osMapset.c_str());
-    G_reset_mapsets();
-    G_add_mapset_to_search_path(osMapset.c_str());
+    GRASSSession::SetEnv(osGisdbase, osLocation, osMapset);
 
     /* -------------------------------------------------------------------- */
     /*      Open GRASS vector map                                           */
@@ -191,20 +191,7 @@ OGRGRASSLayer::OGRGRASSLayer(int layerIndex, struct Map_info *map)
         // Note: we do not have to reset GISDBASE and LOCATION_NAME because
         // OGRGRASSLayer constructor is called from OGRGRASSDataSource::Open
         // where those variables are set
-
-        struct Key_Value *projinfo = G_get_projinfo();
-        struct Key_Value *projunits = G_get_projunits();
-
-        char *srsWkt = GPJ_grass_to_wkt(projinfo, projunits, 0, 0);
-        if (srsWkt)
-        {
-            poSRS = new OGRSpatialReference(srsWkt);
-            poSRS->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
-            G_free(srsWkt);
-        }
-
-        G_free_key_value(projinfo);
-        G_free_key_value(projunits);
+        poSRS = GRASSSession::GetSpatialRef();
     }
 }
 
@@ -213,6 +200,8 @@ OGRGRASSLayer::OGRGRASSLayer(int layerIndex, struct Map_info *map)
 /************************************************************************/
 OGRGRASSLayer::~OGRGRASSLayer()
 {
+    auto oLock = GRASSSession::Acquire();
+
     if (bCursorOpened)
     {
         db_close_cursor(poCursor);
@@ -263,6 +252,11 @@ auto OGRGRASSLayer::StartDbDriver() -> bool
     {
         return false;
     }
+
+    // the database path may refer to the current GRASS variables
+    auto oLock = GRASSSession::Acquire();
+    GRASSSession::SetEnv(poMap->gisdbase, poMap->location, poMap->mapset);
+
     poDriver = db_start_driver_open_database(poLink->driver, poLink->database);
 
     if (poDriver == nullptr)
@@ -319,6 +313,8 @@ auto OGRGRASSLayer::StopDbDriver() -> bool
 /************************************************************************/
 void OGRGRASSLayer::ResetReading()
 {
+    auto oLock = GRASSSession::Acquire();
+
     iNextId = 0;
 
     if (bCursorOpened)
@@ -375,6 +371,7 @@ auto OGRGRASSLayer::SetNextByIndex(GIntBig nIndex) -> OGRErr
 auto OGRGRASSLayer::SetAttributeFilter(const char *query) -> OGRErr
 {
     CPLDebug("GRASS", "SetAttributeFilter: %s", query);
+    auto oLock = GRASSSession::Acquire();
 
     if (query == nullptr)
     {
@@ -626,6 +623,7 @@ void OGRGRASSLayer::SetSpatialFilter(OGRGeometry *poGeomIn)
 #endif
 {
     CPLDebug("GRASS", "SetSpatialFilter");
+    auto oLock = GRASSSession::Acquire();
 
 #if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 11, 0)
     OGRLayer::ISetSpatialFilter(iGeomField, poGeomIn);
@@ -716,6 +714,7 @@ auto OGRGRASSLayer::SetSpatialMatch() -> bool
 auto OGRGRASSLayer::GetNextFeature() -> OGRFeature *
 {
     CPLDebug("GRASS", "OGRGRASSLayer::GetNextFeature");
+    auto oLock = GRASSSession::Acquire();
     OGRFeature *poFeature = nullptr;
 
     int cat = 0;
@@ -833,6 +832,8 @@ auto OGRGRASSLayer::GetFeature(GIntBig nFeatureId) -> OGRFeature *
     CPLDebug("GRASS", "OGRGRASSLayer::GetFeature nFeatureId = " CPL_FRMT_GIB,
              nFeatureId);
 
+    auto oLock = GRASSSession::Acquire();
+
     int cat = 0;
     OGRGeometry *poOGR = GetFeatureGeometry(nFeatureId, &cat);
 
@@ -1075,6 +1076,7 @@ auto OGRGRASSLayer::GetExtent(OGREnvelope *psExtent, int /*bForce*/) -> OGRErr
     {
     };
 
+    auto oLock = GRASSSession::Acquire();
     Vect_get_map_box(poMap, &box);
 
     psExtent->MinX = box.W;